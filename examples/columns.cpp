@@ -0,0 +1,68 @@
+#include <cstring>
+#include <iostream>
+#include <jka/column_exporter.h>
+#include <jka/columns.h>
+#include <jka/demo.h>
+
+using namespace DemoJKA;
+
+namespace {
+
+int exportDemo(const char* demoFile, const char* prefix) {
+    Demo demo;
+    if (!demo.open(demoFile, false)) {
+        std::cerr << "Failed to open demo file: " << demoFile << "\n";
+        return 1;
+    }
+
+    ColumnExporter exporter(demo);
+
+    try {
+        if (!exporter.write(prefix)) {
+            std::cerr << "Failed to export " << demoFile << "\n";
+            return 1;
+        }
+    }
+    catch (std::exception& e) {
+        std::cerr << "Cannot export " << demoFile << ": " << e.what() << "\n";
+        return 1;
+    }
+
+    std::cout << "Written: " << prefix << ".*.jkcol\n"
+              << "Snapshots: " << exporter.getSnapshotsCount() << "\n"
+              << "Entity rows: " << exporter.getEntityRowsCount() << "\n";
+    return 0;
+}
+
+int describe(const char* filename) {
+    static const char* types[] = { "int", "float", "string" };
+    static const char* encodings[] = { "raw", "varint", "delta" };
+
+    ColumnFile file;
+    if (!file.open(filename)) {
+        std::cerr << "Not a column file: " << filename << "\n";
+        return 1;
+    }
+
+    for (int i = 0; i < file.getColumnsCount(); ++i) {
+        const ColumnInfo& info = file.getColumn(i);
+        std::cout << info.name << "\t" << types[info.type] << "\t" << encodings[info.encoding]
+                  << "\t" << info.rows << " rows\t" << info.size << " bytes\n";
+    }
+
+    return 0;
+}
+
+}
+
+int main(int argc, char** argv) {
+    if (argc == 4 && !strcmp(argv[1], "export"))
+        return exportDemo(argv[2], argv[3]);
+
+    if (argc == 3 && !strcmp(argv[1], "info"))
+        return describe(argv[2]);
+
+    std::cerr << "Usage: " << argv[0] << " export <demo.dm_26> <prefix>\n"
+              << "       " << argv[0] << " info <table.jkcol>\n";
+    return 1;
+}
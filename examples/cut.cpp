@@ -0,0 +1,50 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <jka/demo.h>
+#include <jka/cutter.h>
+
+using namespace DemoJKA;
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <in.dm_26> <out.dm_26> [--from T1] [--to T2]\n"
+                  << "  T1, T2: server time in milliseconds\n";
+        return 1;
+    }
+
+    int from = 0;
+    int to = -1;
+
+    for (int i = 3; i < argc; i++) {
+        if (!strcmp(argv[i], "--from") && i + 1 < argc) {
+            from = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--to") && i + 1 < argc) {
+            to = atoi(argv[++i]);
+        }
+        else {
+            std::cerr << "Unknown option: " << argv[i] << "\n";
+            return 1;
+        }
+    }
+
+    // Pas besoin d'analyse : le découpage ne lit que les en-têtes
+    Demo demo;
+    if (!demo.open(argv[1], false)) {
+        std::cerr << "Failed to open demo file: " << argv[1] << "\n";
+        return 1;
+    }
+
+    DemoCutter cutter(demo);
+    if (!cutter.cut(argv[2], from, to)) {
+        std::cerr << "Cannot cut [" << from << ", " << to << "] from " << argv[1] << "\n";
+        return 1;
+    }
+
+    std::cout << "Written: " << argv[2] << " (messages "
+              << cutter.getFirstMessage() << " to " << cutter.getLastMessage() - 1 << ")\n";
+
+    demo.close();
+    return 0;
+}
@@ -1,109 +1,88 @@
-#include <iostream>
+#include <cstring>
 #include <fstream>
+#include <iostream>
 #include <string>
-#include <nlohmann/json.hpp>
 #include <jka/demo.h>
-#include <jka/message.h>
-#include <jka/instruction.h>
-#include <jka/state.h>
+#include <jka/demo_block.h>
+#include <jka/json_writer.h>
 
-using json = nlohmann::json;
 using namespace DemoJKA;
 
-static json serializeInstruction(const Instruction* instr) {
-    json j;
-    if (!instr) return j;
-
-    switch (instr->getType()) {
-        case InstructionType::MapChange: {
-            auto* mc = dynamic_cast<const MapChange*>(instr);
-            j["type"] = "map_change";
-            j["map"]  = mc->map();
-            break;
-        }
-        case InstructionType::ServerCommand: {
-            auto* sc = dynamic_cast<const ServerCommand*>(instr);
-            j["type"]    = "server_command";
-            j["command"] = sc->command();
-            j["args"]    = sc->args();
-            break;
-        }
-        case InstructionType::PlayerState: {
-            auto* ps = dynamic_cast<const PlayerStateInstr*>(instr);
-            j["type"] = "player_state";
-            j["origin"] = { ps->origin()[0], ps->origin()[1], ps->origin()[2] };
-            j["angles"] = { ps->angles()[0], ps->angles()[1], ps->angles()[2] };
-            j["weapon"] = ps->weapon();
-            j["health"] = ps->health();
-            break;
-        }
-        case InstructionType::EntityState: {
-            auto* es = dynamic_cast<const EntityStateInstr*>(instr);
-            j["type"] = "entity_state";
-            j["entity_num"] = es->entityNum();
-
-            json fields;
-            for (const auto& [fieldName, value] : es->netFields()) {
-                fields[fieldName] = value;
-            }
-            j["fields"] = fields;
-            break;
-        }
-        default:
-            j["type"] = "unknown";
-            break;
-    }
-    return j;
-}
-
+// Messages are decoded and written one at a time: memory does not grow
+// with the demo. With --ndjson each message is one line, otherwise the
+// output is a single document {"filename", "messages_count", "messages"}.
 int main(int argc, char** argv) {
-    if (argc < 3) {
-        std::cerr << "Usage: " << argv[0] << " <input.dm_26> <output.json>" << std::endl;
+    bool ndjson = argc > 1 && !strcmp(argv[1], "--ndjson");
+    int first = ndjson ? 2 : 1;
+
+    if (argc - first != 2) {
+        std::cerr << "Usage: " << argv[0] << " [--ndjson] <input.dm_26> <output.json|->" << std::endl;
         return 1;
     }
 
-    std::string inputFile = argv[1];
-    std::string outputFile = argv[2];
+    std::string inputFile = argv[first];
+    std::string outputFile = argv[first + 1];
 
     Demo demo;
-    if (!demo.open(inputFile.c_str(), true)) {
+    if (!demo.open(inputFile.c_str(), false)) {
         std::cerr << "Failed to open demo file: " << inputFile << std::endl;
         return 1;
     }
 
-    json root;
-    root["filename"] = inputFile;
-    root["messages_count"] = demo.getMessageCount();
-
-    auto huffStream = std::make_shared<HuffmanStream>();
-    json messages = json::array();
+    std::ofstream file;
+    if (outputFile != "-") {
+        file.open(outputFile, std::ios::binary);
+        if (!file) {
+            std::cerr << "Failed to write JSON to " << outputFile << std::endl;
+            return 1;
+        }
+    }
 
-    for (int i = 0; i < demo.getMessageCount(); i++) {
-        Message* msg = demo.getMessage(i);
-        if (!msg) continue;
+    std::ostream& out = outputFile == "-" ? std::cout : file;
+    JsonWriter json(out, 4 << 20);
+
+    if (!ndjson) {
+        json.beginObject();
+        json.key("filename");
+        json.value(inputFile);
+        json.key("messages_count");
+        json.value(demo.getMessageCount());
+        json.key("messages");
+        json.beginArray();
+    }
 
-        json jmsg;
-        jmsg["index"] = i;
-        jmsg["size"]  = msg->size();
+    DemoBlock block;
 
-        json instructions = json::array();
-        for (const auto& instr : msg->instructions()) {
-            instructions.push_back(serializeInstruction(instr.get()));
+    for (int i = 0; i < demo.getMessageCount(); i++) {
+        Message msg;
+        try {
+            if (!demo.readRawMessage(i, block) || !decodeDemoBlock(msg, block)) {
+                std::cerr << "Failed to read message " << i << std::endl;
+                return 1;
+            }
+        }
+        catch (std::exception& e) {
+            std::cerr << "Cannot decode message " << i << ": " << e.what() << std::endl;
+            return 1;
         }
 
-        jmsg["instructions"] = instructions;
-        messages.push_back(jmsg);
+        writeMessageJson(json, msg, i);
+        if (ndjson)
+            json.newline();
     }
 
-    root["messages"] = messages;
+    if (!ndjson) {
+        json.endArray();
+        json.endObject();
+        json.newline();
+    }
 
-    std::ofstream out(outputFile);
-    if (!out) {
+    if (!json.flush()) {
         std::cerr << "Failed to write JSON to " << outputFile << std::endl;
         return 1;
     }
 
-    out << root.dump(2);
-    std::cout << "Exported demo JSON to " << outputFile << std::endl;
+    if (outputFile != "-")
+        std::cout << "Exported demo JSON to " << outputFile << std::endl;
     return 0;
 }
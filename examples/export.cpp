@@ -0,0 +1,62 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <jka/demo.h>
+#include <jka/parallel_exporter.h>
+
+using namespace DemoJKA;
+
+namespace {
+
+int usage(const char* program) {
+    std::cerr << "Usage: " << program << " [--csv] [--threads N] [--zstd LEVEL] <demo.dm_26> <output>\n";
+    return 1;
+}
+
+}
+
+int main(int argc, char** argv) {
+    ExportFormat format = EXPORT_NDJSON;
+    int threads = 0;
+    int level = 0;
+
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-' && argv[i][1] == '-'; ++i) {
+        if (!strcmp(argv[i], "--csv"))
+            format = EXPORT_CSV;
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--zstd") && i + 1 < argc)
+            level = atoi(argv[++i]);
+        else
+            return usage(argv[0]);
+    }
+
+    if (argc - i != 2)
+        return usage(argv[0]);
+
+    Demo demo;
+    if (!demo.open(argv[i], false)) {
+        std::cerr << "Failed to open demo file: " << argv[i] << "\n";
+        return 1;
+    }
+
+    try {
+        ParallelExporter exporter(demo);
+        exporter.setFormat(format);
+        exporter.setThreadCount(threads);
+        exporter.setCompression(level);
+
+        if (!exporter.write(argv[i + 1])) {
+            std::cerr << "Failed to export " << argv[i] << " to " << argv[i + 1] << "\n";
+            return 1;
+        }
+    }
+    catch (std::exception& e) {
+        std::cerr << "Cannot export " << argv[i] << ": " << e.what() << "\n";
+        return 1;
+    }
+
+    std::cout << "Exported " << demo.getMessageCount() << " messages to " << argv[i + 1] << "\n";
+    return 0;
+}
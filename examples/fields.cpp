@@ -0,0 +1,43 @@
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <jka/state_writers.hpp>
+
+using namespace DemoJKA;
+
+namespace {
+
+int usage(const char* program) {
+    std::cerr << "Usage: " << program << " [--json]\n"
+              << "Lists entity and player state leaves (netfield names) in export order.\n";
+    return 1;
+}
+
+}
+
+int main(int argc, char** argv) {
+    bool json = false;
+
+    if (argc == 2 && !strcmp(argv[1], "--json"))
+        json = true;
+    else if (argc != 1)
+        return usage(argv[0]);
+
+    if (json) { //record layout, one empty state of each type
+        JsonWriter writer(std::cout);
+        jka::writeJson(writer, jka::EntityState{});
+        writer.newline();
+        jka::writeJson(writer, jka::PlayerState{});
+        writer.newline();
+        return writer.flush() ? 0 : 1;
+    }
+
+    std::string header;
+    jka::appendEntityCsvHeader(header);
+    std::cout << "entity: " << header;
+
+    header.clear();
+    jka::appendPlayerCsvHeader(header);
+    std::cout << "player: " << header;
+    return 0;
+}
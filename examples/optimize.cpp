@@ -0,0 +1,65 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <jka/demo.h>
+#include <jka/optimizer.h>
+
+using namespace DemoJKA;
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <in.dm_26> <out.dm_26> [--rebase] [--threads N]\n"
+                  << "  --rebase: delta every snapshot against previous message (slower)\n";
+        return 1;
+    }
+
+    bool rebase = false;
+    int threads = 0;
+
+    for (int i = 3; i < argc; i++) {
+        if (!strcmp(argv[i], "--rebase")) {
+            rebase = true;
+        }
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        }
+        else {
+            std::cerr << "Unknown option: " << argv[i] << "\n";
+            return 1;
+        }
+    }
+
+    Demo demo;
+    if (!demo.open(argv[1], true)) {
+        std::cerr << "Failed to open demo file: " << argv[1] << "\n";
+        return 1;
+    }
+
+    DemoOptimizer optimizer(demo);
+    optimizer.setRebaseDeltas(rebase);
+
+    try {
+        optimizer.run();
+    }
+    catch (std::exception& e) {
+        std::cerr << "Cannot optimize " << argv[1] << ": " << e.what() << "\n";
+        return 1;
+    }
+
+    // Seuls les messages modifiés sont ré-encodés
+    demo.setSaveThreads(threads);
+    if (!demo.save(argv[2], true)) {
+        std::cerr << "Failed to write demo file: " << argv[2] << "\n";
+        return 1;
+    }
+
+    const OptimizerStats& stats = optimizer.getStats();
+    std::cout << "Written: " << argv[2] << "\n"
+              << "Keyframes converted: " << stats.keyframesConverted << "\n"
+              << "Snapshots rebased: " << stats.snapshotsRebased << "\n"
+              << "Entities dropped: " << stats.entitiesDropped << "\n"
+              << "Commands dropped: " << stats.commandsDropped << "\n";
+
+    demo.close();
+    return 0;
+}
@@ -0,0 +1,63 @@
+#ifndef BG_DEFS_H
+#define BG_DEFS_H
+
+#include <jka/defs.h>
+
+// Game module constants shared by client and server (JKA bg_public.h, q_shared.h)
+
+// Limits
+constexpr int MAX_CLIENTS = 32;
+constexpr int MAX_MODELS = 512;
+constexpr int MAX_SOUNDS = 256;
+constexpr int MAX_ICONS = 64;
+
+// Configstring indexes
+constexpr int CS_SERVERINFO = 0;        /* info string with serverinfo cvars */
+constexpr int CS_SYSTEMINFO = 1;        /* info string with systeminfo cvars */
+constexpr int CS_MUSIC = 2;
+constexpr int CS_MESSAGE = 3;           /* worldspawn message */
+constexpr int CS_MOTD = 4;
+constexpr int CS_WARMUP = 5;            /* server time when match restarts */
+constexpr int CS_SCORES1 = 6;
+constexpr int CS_SCORES2 = 7;
+constexpr int CS_VOTE_TIME = 8;
+constexpr int CS_VOTE_STRING = 9;
+constexpr int CS_VOTE_YES = 10;
+constexpr int CS_VOTE_NO = 11;
+constexpr int CS_GAME_VERSION = 20;
+constexpr int CS_LEVEL_START_TIME = 21; /* server time the level started */
+constexpr int CS_INTERMISSION = 22;
+constexpr int CS_FLAGSTATUS = 23;
+constexpr int CS_MODELS = 298;          /* MAX_MODELS entries */
+constexpr int CS_SKYBOXORG = CS_MODELS + MAX_MODELS;
+constexpr int CS_SOUNDS = CS_SKYBOXORG + 1;
+constexpr int CS_ICONS = CS_SOUNDS + MAX_SOUNDS;
+constexpr int CS_PLAYERS = CS_ICONS + MAX_ICONS; /* one info string per client */
+
+// Entities
+constexpr int ENTITYNUM_NONE = MAX_GENTITIES - 1;
+constexpr int ENTITYNUM_WORLD = MAX_GENTITIES - 2;
+constexpr int ET_PLAYER = 1;
+constexpr int ET_EVENTS = 18;           /* eType of temp entities: ET_EVENTS + event */
+constexpr int EF_PLAYER_EVENT = 0x00000020; /* temp entity carries a client event, client in otherEntityNum */
+
+// Player state
+constexpr int STAT_HEALTH = 0;
+
+// Events
+constexpr int EV_EVENT_BIT1 = 0x00000100;
+constexpr int EV_EVENT_BIT2 = 0x00000200;
+constexpr int EV_EVENT_BITS = EV_EVENT_BIT1 | EV_EVENT_BIT2; /* sequence bits of entity events */
+constexpr int MAX_PS_EVENTS = 2;
+constexpr int EVENT_VALID_MSEC = 300;   /* entity gone longer than that can refire its event */
+
+constexpr int EV_ITEM_PICKUP = 22;      /* eventParm item, on picking player */
+constexpr int EV_GLOBAL_ITEM_PICKUP = 23;
+constexpr int EV_SABER_HIT = 30;        /* otherEntityNum victim, otherEntityNum2 attacker */
+constexpr int EV_PAIN = 89;             /* eventParm health, on hurt entity */
+constexpr int EV_OBITUARY = 93;         /* otherEntityNum victim, otherEntityNum2 killer, eventParm means of death */
+
+static_assert(CS_PLAYERS == 1131, "configstring layout differs from JKA");
+static_assert(CS_PLAYERS + MAX_CLIENTS <= MAX_CONFIGSTRINGS, "configstring layout overflow");
+
+#endif // BG_DEFS_H
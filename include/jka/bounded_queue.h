@@ -0,0 +1,83 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <jka/defs.h>
+
+DEMO_NAMESPACE_START
+
+/**
+ * @brief Blocking FIFO with fixed capacity, shared by a producer and a consumer.
+ *
+ * push() waits while the queue is full, which slows the producer down to the
+ * speed of the consumer (backpressure). After close(), push() is ignored and
+ * pop() returns the remaining items, then false.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity(capacity ? capacity : 1), closed(false) {}
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /// Appends value, waits while the queue is full.
+    /// @return false if queue was closed
+    bool push(T value) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this] { return closed || items.size() < capacity; });
+
+        if (closed)
+            return false;
+
+        items.push_back(std::move(value));
+        lock.unlock();
+        notEmpty.notify_one();
+        return true;
+    }
+
+    /// Removes oldest value, waits while the queue is empty.
+    /// @return false if queue is closed and drained
+    bool pop(T& value) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this] { return closed || !items.empty(); });
+
+        if (items.empty())
+            return false;
+
+        value = std::move(items.front());
+        items.pop_front();
+        lock.unlock();
+        notFull.notify_one();
+        return true;
+    }
+
+    /// Wakes up all waiting threads, no more values are accepted.
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return items.size();
+    }
+
+private:
+    const size_t            capacity;
+    bool                    closed;
+    std::deque<T>           items;
+    mutable std::mutex      mutex;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+};
+
+DEMO_NAMESPACE_END
+
+#endif // BOUNDED_QUEUE_H
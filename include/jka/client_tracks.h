@@ -0,0 +1,73 @@
+#ifndef CLIENT_TRACKS_H
+#define CLIENT_TRACKS_H
+
+#include <vector>
+#include <jka/bg_defs.h>
+#include <jka/delta_resolver.h>
+#include <jka/demo.h>
+
+DEMO_NAMESPACE_START
+
+/**
+ * @brief Time series of one client, one contiguous column per value.
+ *
+ * Sample i of every column belongs to the same snapshot. Columns are plain
+ * arrays so analysis code can run over them with vector instructions.
+ */
+struct ClientTrack {
+    std::vector<int>   time;          ///< snapshot server time
+    std::vector<float> originX, originY, originZ;
+    std::vector<float> velocityX, velocityY, velocityZ;
+    std::vector<float> pitch, yaw, roll; ///< view angles
+    std::vector<int>   weapon;
+    std::vector<int>   legsAnim;
+    std::vector<int>   torsoAnim;
+    std::vector<int>   health;        ///< -1 when unknown (only sent for recording player)
+    std::vector<char>  fromPlayerState; ///< 1 if sample is from recording player state
+
+    size_t size() const { return time.size(); }
+    bool empty() const { return time.empty(); }
+
+    void clear();
+    void reserve(size_t samples);
+};
+
+/**
+ * @brief Per client tracks of a demo, built while resolving deltas.
+ *
+ * Entity slots 0 to MAX_CLIENTS-1 of type ET_PLAYER give the other
+ * players: position and view angles come from pos/apos.trBase, velocity from
+ * pos.trDelta (players are sent TR_INTERPOLATE with their velocity). The
+ * recording player is not in entities, its samples come from player state.
+ *
+ * Only the netfields needed are resolved (see DeltaResolver), no Snapshot is
+ * built.
+ */
+class ClientTracks {
+public:
+    ClientTracks();
+
+    /// Drops samples and resolver state.
+    void clear();
+
+    /// Feeds a decoded message, messages must come in order.
+    void update(Message* message);
+
+    /// Feeds all messages of demo, decoding them without loading them in demo.
+    /// @return false if a message cannot be read
+    bool build(const Demo& demo);
+
+    /// Track of client (0 to MAX_CLIENTS-1).
+    const ClientTrack& getTrack(int clientNum) const { return tracks[clientNum]; }
+
+private:
+    void addEntity(int clientNum, const DeltaResolver::Frame& frame, int i);
+    void addPlayer(const DeltaResolver::Frame& frame);
+
+    DeltaResolver            resolver;
+    std::vector<ClientTrack> tracks; //MAX_CLIENTS
+};
+
+DEMO_NAMESPACE_END
+
+#endif // CLIENT_TRACKS_H
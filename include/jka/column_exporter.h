@@ -0,0 +1,45 @@
+#ifndef COLUMN_EXPORTER_H
+#define COLUMN_EXPORTER_H
+
+#include <string>
+#include <jka/columns.h>
+#include <jka/demo.h>
+
+DEMO_NAMESPACE_START
+
+/**
+ * @brief Exports a demo as .jkcol tables (see columns.h), in one pass.
+ *
+ * Tables, one file each:
+ * - <prefix>.snapshots.jkcol: message, sequence, serverTime, deltaNum,
+ *   snapFlags, entities
+ * - <prefix>.player.jkcol: message, serverTime, then every player netfield
+ *   and stats/persistant/ammo/powerups entry, one column each
+ * - <prefix>.entities.jkcol: message, serverTime, number, then every entity
+ *   netfield; one row per entity in each snapshot
+ * - <prefix>.commands.jkcol: message, serverTime, sequence, text
+ * - <prefix>.events.jkcol: GameEvent fields (see EventExtractor)
+ *
+ * Snapshots are resolved, so every row holds full values. Integers are
+ * delta or varint encoded, floats are kept raw so they can be mapped.
+ */
+class ColumnExporter {
+public:
+    explicit ColumnExporter(const Demo& demo);
+
+    /// Writes tables. Returns false if demo cannot be read or a file written.
+    bool write(const std::string& prefix);
+
+    /// Rows written by last write().
+    int getSnapshotsCount() const { return snapshots; }
+    int getEntityRowsCount() const { return entityRows; }
+
+private:
+    const Demo& demo;
+    int         snapshots;
+    int         entityRows;
+};
+
+DEMO_NAMESPACE_END
+
+#endif // COLUMN_EXPORTER_H
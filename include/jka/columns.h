@@ -0,0 +1,137 @@
+#ifndef COLUMNS_H
+#define COLUMNS_H
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <jka/defs.h>
+#include <jka/demo_source.h>
+
+DEMO_NAMESPACE_START
+
+/**
+ * .jkcol column file layout (all numbers little endian):
+ *
+ *     "JKCOL1\0\0"                 8 bytes magic
+ *     column data...               each column starts 8 bytes aligned
+ *     footer                       per column: name (varint length, bytes),
+ *                                  type (byte), encoding (byte),
+ *                                  rows, offset, size (varints)
+ *     footer size                  4 bytes
+ *     "JKC1"                       4 bytes magic
+ *
+ * Encodings:
+ * - ENCODING_RAW: 4 bytes per int or float value (floats can be used in
+ *   place from a mapped file); strings as varint length and bytes
+ * - ENCODING_VARINT: zigzag varint per value
+ * - ENCODING_DELTA_VARINT: zigzag varint of difference with previous value
+ *   (first one with 0), for counters and slowly changing values
+ */
+enum ColumnType {
+    COLUMN_INT = 0,
+    COLUMN_FLOAT,
+    COLUMN_STRING
+};
+
+enum ColumnEncoding {
+    ENCODING_RAW = 0,
+    ENCODING_VARINT,
+    ENCODING_DELTA_VARINT
+};
+
+/// Column description, as stored in footer.
+struct ColumnInfo {
+    std::string    name;
+    ColumnType     type;
+    ColumnEncoding encoding;
+    size_t         rows;
+    size_t         offset; ///< data position in file
+    size_t         size;   ///< data bytes
+};
+
+/**
+ * @brief Writes one table as a .jkcol file.
+ *
+ * Columns are encoded in memory as values are appended, and written with the
+ * footer on close().
+ */
+class ColumnWriter {
+public:
+    ColumnWriter();
+    ~ColumnWriter();
+
+    ColumnWriter(const ColumnWriter&) = delete;
+    ColumnWriter& operator=(const ColumnWriter&) = delete;
+
+    /// Adds a column. Strings support ENCODING_RAW only, floats RAW and VARINT
+    /// (of their bits).
+    /// @return column index for append methods
+    int addColumn(const std::string& name, ColumnType type, ColumnEncoding encoding = ENCODING_DELTA_VARINT);
+
+    void appendInt(int column, int value);
+    void appendFloat(int column, float value);
+    void appendString(int column, std::string_view value);
+
+    int getColumnsCount() const { return (int)columns.size(); }
+
+    /// Writes file. Returns false if it cannot be written.
+    bool write(const std::string& filename) const;
+
+    /// Drops columns and their data.
+    void clear();
+
+private:
+    struct Column {
+        ColumnInfo        info;
+        std::vector<byte> data;
+        int               last; //previous value for delta encoding
+    };
+
+    void appendBits(Column& column, int value);
+
+    std::vector<Column> columns;
+};
+
+/**
+ * @brief Reads a .jkcol file, mapped in memory when the platform allows.
+ *
+ * Only the columns asked for are decoded. Throws DemoException when decoding
+ * corrupted data.
+ */
+class ColumnFile {
+public:
+    ColumnFile();
+    ~ColumnFile();
+
+    /// Opens file and reads its footer, false if it is not a column file.
+    bool open(const std::string& filename);
+
+    int getColumnsCount() const { return (int)columns.size(); }
+    const ColumnInfo& getColumn(int i) const { return columns[i]; }
+
+    /// Index of column named name, -1 if missing.
+    int findColumn(std::string_view name) const;
+
+    std::vector<int> readInts(int column) const;
+    std::vector<float> readFloats(int column) const;
+
+    /// Views point into file data, valid as long as it is open.
+    std::vector<std::string_view> readStrings(int column) const;
+
+    /// Values of a raw float column used in place, null for other encodings.
+    const float* floatData(int column) const;
+
+private:
+    const byte* columnData(const ColumnInfo& info) const;
+
+    std::unique_ptr<DemoSource> source;
+    const byte*                 data;
+    size_t                      length;
+    std::vector<byte>           owned; //file content when it cannot be mapped
+    std::vector<ColumnInfo>     columns;
+};
+
+DEMO_NAMESPACE_END
+
+#endif // COLUMNS_H
@@ -0,0 +1,114 @@
+#ifndef COMMAND_DECODER_H
+#define COMMAND_DECODER_H
+
+#include <string_view>
+#include <jka/bg_defs.h>
+#include <jka/command_tokenizer.h>
+
+DEMO_NAMESPACE_START
+
+/// Server commands with a typed decoder (or handled elsewhere, as bcs).
+enum ServerCommandType {
+    SCMD_UNKNOWN = 0,
+    SCMD_CS,            ///< configstring change
+    SCMD_BCS0,          ///< big configstring fragments, see ConfigstringParser
+    SCMD_BCS1,
+    SCMD_BCS2,
+    SCMD_PRINT,         ///< console print
+    SCMD_CP,            ///< center print
+    SCMD_CHAT,
+    SCMD_TCHAT,         ///< team chat
+    SCMD_SCORES,        ///< scoreboard
+    SCMD_TINFO,         ///< team overlay info
+    SCMD_MAP_RESTART,
+    SCMD_DISCONNECT
+};
+
+/// Type of command named name (first argument).
+ServerCommandType getServerCommandType(std::string_view name);
+
+/// "cs <index> <value>"
+struct ConfigstringEvent {
+    int              index;
+    std::string_view value;
+};
+
+/// "print <text>" or "cp <text>"
+struct PrintEvent {
+    bool             center;
+    std::string_view text;
+};
+
+/// "chat <text> [clientNum]" or "tchat <text> [clientNum]"
+///
+/// Text is "<name>^7\x19: ^<color><message>", team chat is
+/// "\x19(<name>^7\x19)\x19: ^<color><message>" (G_Say); it is split into
+/// speaker and message when possible.
+struct ChatEvent {
+    bool             team;
+    int              clientNum;  ///< -1 when not sent
+    std::string_view text;       ///< whole text
+    std::string_view speaker;    ///< name with color codes, empty if text has no speaker
+    std::string_view message;    ///< text after speaker and color code
+};
+
+/// One scoreboard row (cg_servercmds.c CG_ParseScores).
+struct ScoreEntry {
+    int client;
+    int score;
+    int ping;
+    int time;
+    int scoreFlags;
+    int powerups;
+    int accuracy;
+    int impressiveCount;
+    int excellentCount;
+    int gauntletCount;
+    int defendCount;
+    int assistCount;
+    int perfect;
+    int captures;
+};
+
+/// "scores <count> <red> <blue> <14 fields per client>..."
+struct ScoresEvent {
+    static const int FIELDS = 14;
+
+    int        count;
+    int        redScore;
+    int        blueScore;
+    ScoreEntry entries[MAX_CLIENTS];
+};
+
+/// One team overlay row (cg_servercmds.c CG_ParseTeamInfo).
+struct TeamInfoEntry {
+    int client;
+    int location;
+    int health;
+    int armor;
+    int weapon;
+    int powerups;
+};
+
+/// "tinfo <count> <6 fields per client>..."
+struct TeamInfoEvent {
+    static const int FIELDS = 6;
+
+    int           count;
+    TeamInfoEntry entries[MAX_CLIENTS];
+};
+
+/// Decoders read a tokenized command (see CommandTokenizer). They return
+/// false if command has another name or is malformed. Views point into the
+/// tokenized text.
+bool decodeConfigstring(const CommandTokenizer& command, ConfigstringEvent& event);
+bool decodePrint(const CommandTokenizer& command, PrintEvent& event);
+bool decodeChat(const CommandTokenizer& command, ChatEvent& event);
+
+/// Count is clamped to MAX_CLIENTS and to the rows fully present.
+bool decodeScores(const CommandTokenizer& command, ScoresEvent& event);
+bool decodeTeamInfo(const CommandTokenizer& command, TeamInfoEvent& event);
+
+DEMO_NAMESPACE_END
+
+#endif // COMMAND_DECODER_H
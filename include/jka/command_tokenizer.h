@@ -0,0 +1,57 @@
+#ifndef COMMAND_TOKENIZER_H
+#define COMMAND_TOKENIZER_H
+
+#include <string_view>
+#include <jka/defs.h>
+
+DEMO_NAMESPACE_START
+
+/**
+ * @brief Splits a server command into arguments as Cmd_TokenizeString does.
+ *
+ * Arguments are separated by whitespace (any char up to ' '), quoted
+ * arguments keep their spaces and lose their quotes, "//" ends the line
+ * and C style block comments are skipped. A quote also ends an unquoted
+ * argument.
+ *
+ * Arguments are views into tokenized text, which must outlive them; nothing
+ * is copied or allocated. Tokenizers are meant to be reused.
+ */
+class CommandTokenizer {
+public:
+    static const int MAX_TOKENS = 1024; //MAX_STRING_TOKENS
+
+    CommandTokenizer() : text(), count(0) {}
+    explicit CommandTokenizer(std::string_view text) { tokenize(text); }
+
+    CommandTokenizer(const CommandTokenizer&) = delete;
+    CommandTokenizer& operator=(const CommandTokenizer&) = delete;
+
+    /// Splits text, forgetting previous arguments.
+    /// @return number of arguments
+    int tokenize(std::string_view text);
+
+    /// Number of arguments, command name included.
+    int argc() const { return count; }
+
+    /// Argument i (0 is command name), empty if out of range.
+    std::string_view argv(int i) const { return (i >= 0 && i < count) ? tokens[i] : std::string_view(); }
+
+    /// Argument i read as atoi does, 0 if out of range.
+    int argi(int i) const { return toInt(argv(i)); }
+
+    /// Raw text from argument i to the end (quotes included), empty if out of range.
+    std::string_view rest(int i) const;
+
+    /// Leading integer of s, as atoi (optional whitespace and sign), saturated to the int range.
+    static int toInt(std::string_view s);
+
+private:
+    std::string_view text;
+    int              count;
+    std::string_view tokens[MAX_TOKENS];
+};
+
+DEMO_NAMESPACE_END
+
+#endif // COMMAND_TOKENIZER_H
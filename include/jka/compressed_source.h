@@ -0,0 +1,61 @@
+#ifndef COMPRESSED_SOURCE_H
+#define COMPRESSED_SOURCE_H
+
+#include <memory>
+#include <jka/demo_source.h>
+
+DEMO_NAMESPACE_START
+
+class CompressedSourceImpl;
+
+/**
+ * @brief Decompresses a gzip or zstd demo on the fly.
+ *
+ * Seek checkpoints are recorded while data is first read in order, so a
+ * demo read from start to end is decoded once. size() and seeks past the
+ * decoded part decode up to the point they need. Reads are served from a
+ * ring of recently decoded chunks; a seek outside of it restarts decoding
+ * from the nearest checkpoint.
+ *
+ * gzip checkpoints hold a full inflate state and are spaced evenly, so any
+ * offset is reached by decoding at most one spacing.
+ *
+ * Limitation: zstd cannot resume inside a frame, so its checkpoints are frame
+ * boundaries only. A usual single-frame .dm_26.zst therefore has one
+ * checkpoint at offset 0 and every seek behind the chunk ring decodes again
+ * from the start: there is no random access, only forward streaming.
+ * Multi-frame files (zstd seekable format, pzstd output) get one
+ * checkpoint per frame.
+ */
+class CompressedSource : public DemoSource {
+public:
+    enum Format {
+        FORMAT_NONE = 0,
+        FORMAT_GZIP,
+        FORMAT_ZSTD
+    };
+
+    /// Looks at magic bytes (gzip: deflate header with valid flags),
+    /// source is rewound to its start.
+    static Format detect(DemoSource& raw);
+
+    /// True if this build can decompress given format.
+    static bool isSupported(Format format);
+
+    /// Wraps raw compressed source (takes ownership).
+    /// Throws DemoException if data is corrupted or format is not supported.
+    CompressedSource(std::unique_ptr<DemoSource> raw, Format format);
+    ~CompressedSource();
+
+    size_t read(void* dest, size_t length) override;
+    bool seek(size_t offset) override;
+    size_t tell() const override;
+    size_t size() const override;
+
+private:
+    std::unique_ptr<CompressedSourceImpl> impl;
+};
+
+DEMO_NAMESPACE_END
+
+#endif // COMPRESSED_SOURCE_H
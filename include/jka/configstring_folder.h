@@ -0,0 +1,63 @@
+#ifndef CONFIGSTRING_FOLDER_H
+#define CONFIGSTRING_FOLDER_H
+
+#include <string>
+#include <string_view>
+#include <jka/defs.h>
+#include <jka/message.h>
+
+DEMO_NAMESPACE_START
+
+/**
+ * @brief Extracts configstring changes from server commands.
+ *
+ * Parses "cs" and joins big configstrings sent in fragments (bcs0, bcs1,
+ * bcs2). Feed commands in sequence order, each one once.
+ */
+class ConfigstringParser {
+public:
+    ConfigstringParser() : bigIndex(-1) {}
+
+    /// Parses one command.
+    /// @return true if it completes a configstring change, given in index and
+    /// value (which stays valid until next call and as long as command)
+    bool parse(std::string_view command, int& index, std::string_view& value);
+
+    /// Drops a big configstring being joined.
+    void reset();
+
+private:
+    int         bigIndex;
+    std::string bigString;
+    std::string joined;
+};
+
+/**
+ * @brief Applies configstring commands on a gamestate, as the client does.
+ *
+ * Handles "cs" and big configstrings sent in fragments (bcs0, bcs1, bcs2).
+ * Commands are resent until acknowledged, each one is applied once.
+ */
+class ConfigstringFolder {
+public:
+    /// Folds into given gamestate (not owned).
+    explicit ConfigstringFolder(Gamestate* gamestate);
+
+    /// Applies server commands of message not applied yet.
+    void update(Message* message);
+
+    /// Applies one command if it is a configstring change.
+    void apply(const ServerCommand* command);
+
+    /// Last server command applied (gamestate command sequence at start).
+    int getCommandSequence() const { return commandSequence; }
+
+private:
+    Gamestate*         gamestate;
+    int                commandSequence;
+    ConfigstringParser parser;
+};
+
+DEMO_NAMESPACE_END
+
+#endif // CONFIGSTRING_FOLDER_H
@@ -0,0 +1,103 @@
+#ifndef CONFIGSTRING_TIMELINE_H
+#define CONFIGSTRING_TIMELINE_H
+
+#include <string_view>
+#include <vector>
+#include <jka/bg_defs.h>
+#include <jka/configstring_folder.h>
+#include <jka/demo.h>
+#include <jka/info_string.h>
+#include <jka/string_arena.h>
+
+DEMO_NAMESPACE_START
+
+/**
+ * @brief History of every configstring over a demo.
+ *
+ * Each index keeps the list of values it took, with the message and server
+ * time they appeared at, so values can be looked up at any point in O(log n).
+ * A gamestate starts a new value for every index it changes, including
+ * indexes it clears.
+ *
+ * Values are stored once in an arena. Info string versions (serverinfo,
+ * players) are indexed on first lookup and cached.
+ *
+ * Changes sent before the first snapshot of a message take effect at this
+ * snapshot time; messages without snapshot use the previous one. Times are
+ * made non-decreasing, so when server time restarts inside a demo, query by
+ * message id.
+ */
+class ConfigstringTimeline {
+public:
+    struct Version {
+        int              messageId;
+        int              serverTime;
+        std::string_view value;
+    };
+
+    ConfigstringTimeline();
+
+    ConfigstringTimeline(const ConfigstringTimeline&) = delete;
+    ConfigstringTimeline& operator=(const ConfigstringTimeline&) = delete;
+
+    /// Scans demo, decoding only messages with a gamestate or server commands.
+    /// Previous content is dropped.
+    /// @return false if a message cannot be read
+    bool build(const Demo& demo);
+
+    /// Incremental building, messages must come in order.
+    void addGamestate(int messageId, int serverTime, const Gamestate& gamestate);
+    void addCommand(int messageId, int serverTime, const ServerCommand& command);
+
+    /// Records a value, ignored if index already has it.
+    void set(int index, int messageId, int serverTime, std::string_view value);
+
+    /// Drops all versions.
+    void clear();
+
+    /// Value in effect at server time (empty before first one).
+    std::string_view valueAt(int index, int serverTime) const;
+
+    /// Value in effect once message was parsed.
+    std::string_view valueAtMessage(int index, int messageId) const;
+
+    /// Info string index of value in effect at server time.
+    const InfoStringView& infoAt(int index, int serverTime) const;
+    const InfoStringView& infoAtMessage(int index, int messageId) const;
+
+    /// All versions of index, oldest first.
+    const std::vector<Version>& getVersions(int index) const { return versions[index]; }
+
+    /// Number of versions over all indexes.
+    int getVersionsCount() const { return versionsCount; }
+
+    /// Dense name tables at server time: modelNames()[modelindex],
+    /// soundNames()[soundindex], playerNames()[clientNum] (the "n" key).
+    std::vector<std::string_view> modelNames(int serverTime) const;
+    std::vector<std::string_view> soundNames(int serverTime) const;
+    std::vector<std::string_view> playerNames(int serverTime) const;
+
+    /// Single entry of the tables above.
+    std::string_view modelName(int modelIndex, int serverTime) const;
+    std::string_view soundName(int soundIndex, int serverTime) const;
+    std::string_view playerName(int clientNum, int serverTime) const;
+
+private:
+    int findAt(int index, int serverTime) const;
+    int findAtMessage(int index, int messageId) const;
+    const InfoStringView& info(int index, int version) const;
+    std::vector<std::string_view> range(int first, int count, int serverTime) const;
+
+    std::vector<std::vector<Version>> versions; //MAX_CONFIGSTRINGS lists
+    int                               versionsCount;
+    int                               lastTime;
+    ConfigstringParser                parser;
+    StringArena                       strings;
+
+    mutable std::vector<std::vector<InfoStringView>> infos; //parallel to versions, filled on demand
+    mutable std::vector<std::vector<bool>>           infoParsed;
+};
+
+DEMO_NAMESPACE_END
+
+#endif // CONFIGSTRING_TIMELINE_H
@@ -0,0 +1,46 @@
+#ifndef DEMO_CUTTER_H
+#define DEMO_CUTTER_H
+
+#include <ostream>
+#include <string_view>
+#include <jka/demo.h>
+
+DEMO_NAMESPACE_START
+
+/**
+ * @brief Extracts a server time window of a demo into a new playable demo.
+ *
+ * Output starts with the gamestate in effect at the window start, with
+ * configstring changes received before the window folded in, followed by a
+ * fully resolved (uncompressed) first snapshot. Following messages are copied
+ * without decoding, except those delta compressed against a message left
+ * out, which are stored uncompressed as well. Sequence numbers are shifted:
+ * the gamestate message gets 1, the first message of the window 2.
+ *
+ * Messages are read from the demo source, changes made to loaded messages
+ * are not taken into account.
+ */
+class DemoCutter {
+public:
+    explicit DemoCutter(const Demo& demo);
+
+    /// Writes messages whose snapshot server time is in [fromTime, toTime].
+    /// @param toTime negative value means demo end
+    /// @return false if window holds no snapshot, there is no gamestate
+    ///         before it or a message cannot be read
+    bool cut(std::string_view filename, int fromTime, int toTime = -1);
+    bool cut(std::ostream& os, int fromTime, int toTime = -1);
+
+    /// Range of source messages [first, last) written by the last cut.
+    int getFirstMessage() const { return firstMessage; }
+    int getLastMessage() const { return lastMessage; }
+
+private:
+    const Demo& demo;
+    int         firstMessage;
+    int         lastMessage;
+};
+
+DEMO_NAMESPACE_END
+
+#endif // DEMO_CUTTER_H
@@ -29,6 +29,7 @@ constexpr int FLOAT_INT_BIAS = (1 << (FLOAT_INT_BITS - 1));
 constexpr int MAX_CONFIGSTRINGS = 1700;
 constexpr int GENTITYNUM_BITS = 10;
 constexpr int MAX_GENTITIES = (1 << GENTITYNUM_BITS);
+constexpr int PACKET_BACKUP = 32; /* snapshots a delta can refer back to */
 
 // Size constants enum class for type safety
 enum class BitSize : int {
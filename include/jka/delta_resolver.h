@@ -0,0 +1,102 @@
+#ifndef DELTA_RESOLVER_H
+#define DELTA_RESOLVER_H
+
+#include <string>
+#include <vector>
+#include <jka/defs.h>
+#include <jka/message.h>
+
+DEMO_NAMESPACE_START
+
+/**
+ * @brief Resolves delta compressed snapshots for a few chosen netfields.
+ *
+ * Unlike SnapshotResolver, no Snapshot is cloned: a frame holds the sorted
+ * entity numbers present and, for each of them, the values of the tracked
+ * fields in one flat array. Entities entering the frame start from their
+ * gamestate baseline. Frames of the last PACKET_BACKUP sequence numbers are
+ * kept for deltas to refer to. Messages must be fed in order.
+ *
+ * Values are raw 32 bits: use getFloat for float netfields.
+ */
+class DeltaResolver {
+public:
+    struct Frame {
+        int              sequenceNumber = -1;
+        int              serverTime = 0;
+        std::vector<int> entities; ///< entity numbers, ascending
+        std::vector<int> values;   ///< entities.size() * entity fields count
+        std::vector<int> player;   ///< player fields, zero without player state
+
+        int getEntitiesCount() const { return (int)entities.size(); }
+
+        /// Position of entity in frame, -1 if absent.
+        int find(int entityNum) const;
+    };
+
+    /// Tracks given entity and player netfields, by name ("eType",
+    /// "pos.trBase[0]", "events[1]"...). Player fields may also name array
+    /// entries: "stats[0]", "persistant[3]", "ammo[2]", "powerups[4]".
+    /// Throws DemoException if a name is not a netfield.
+    DeltaResolver(const std::vector<std::string>& entityFields,
+                  const std::vector<std::string>& playerFields = std::vector<std::string>());
+
+    /// Netfield index of name, -1 if unknown.
+    static int findEntityField(const std::string& name);
+    static int findPlayerField(const std::string& name);
+
+    /// Forgets frames and baselines.
+    void reset();
+
+    /// Feeds a message: gamestate loads baselines, snapshot is resolved.
+    /// @return resolved frame of message (valid until PACKET_BACKUP messages
+    /// later), null if it has none or its base is missing
+    const Frame* update(Message* message);
+
+    /// Loads baselines of tracked fields, drops frames.
+    void setBaselines(const Gamestate& gamestate);
+
+    /// Resolves snapshot received in message with given sequence number.
+    const Frame* resolve(int sequenceNumber, const Snapshot& snapshot);
+
+    /// Resolved frame of sequence number, null if not in window.
+    const Frame* find(int sequenceNumber) const;
+
+    int getEntityFieldsCount() const { return (int)entityFields.size(); }
+    int getPlayerFieldsCount() const { return (int)playerFields.size(); }
+
+    /// Value of tracked entity field (position in constructor list) of
+    /// i-th entity of frame.
+    int get(const Frame& frame, int i, int field) const { return frame.values[i * entityFields.size() + field]; }
+    float getFloat(const Frame& frame, int i, int field) const;
+
+    /// Value of tracked player field.
+    int getPlayer(const Frame& frame, int field) const { return frame.player[field]; }
+    float getPlayerFloat(const Frame& frame, int field) const;
+
+private:
+    enum PlayerArray {
+        PLAYER_FIELD = 0,
+        PLAYER_STATS,
+        PLAYER_PERSISTANT,
+        PLAYER_AMMO,
+        PLAYER_POWERUPS
+    };
+
+    struct PlayerField {
+        PlayerArray array;
+        int         id;    //netfield or array index
+    };
+
+    static bool parsePlayerField(const std::string& name, PlayerField& field);
+    void applyPlayer(const PlayerState& state, int* values) const;
+
+    std::vector<int>         entityFields; //netfield indexes
+    std::vector<PlayerField> playerFields;
+    std::vector<int>         baselines;    //MAX_GENTITIES * entity fields count
+    Frame                    frames[PACKET_BACKUP];
+};
+
+DEMO_NAMESPACE_END
+
+#endif // DELTA_RESOLVER_H
@@ -6,6 +6,8 @@
 #include <string_view>
 #include <fstream>
 #include <jka/message.h>
+#include <jka/demo_range.h>
+#include <jka/demo_source.h>
 
 DEMO_NAMESPACE_START
 
@@ -16,6 +18,30 @@ enum VehicleCheck {
 };
 
 class DemoImpl;
+struct DemoBlock;
+
+/**
+ * @brief Header information of a message, decoded without building instructions.
+ *
+ * Decoding stops at the first snapshot or gamestate, so peeking is much
+ * cheaper than loading the message.
+ */
+struct MessagePeek {
+    int  sequenceNumber = -1;
+    bool hasGamestate = false;
+    bool hasSnapshot = false;
+    bool hasMapChange = false;
+    int  serverCommands = 0;   ///< server commands preceding the first snapshot/gamestate
+    int  serverTime = -1;      ///< first snapshot server time, -1 without snapshot
+    int  deltaNum = -1;        ///< first snapshot delta number, -1 without snapshot
+
+    /// True when the delta chain restarts here (gamestate or uncompressed snapshot).
+    bool isKeyframe() const { return hasGamestate || (hasSnapshot && deltaNum == 0); }
+
+    /// Sequence number of the message this one is delta compressed against
+    /// (-1 for keyframes and messages without snapshot).
+    int deltaSequence() const { return (hasSnapshot && deltaNum > 0) ? sequenceNumber - deltaNum : -1; }
+};
 
 /**
  * @brief High-level interface for working with JKA demo files (dm_26).
@@ -37,6 +63,14 @@ public:
     /// @return true if successful
     bool open(std::string_view filename, bool analysis = true);
 
+    /// Attempts to load demo from any byte source (takes ownership).
+    bool open(std::unique_ptr<DemoSource> source, bool analysis = true);
+
+    /// Attempts to load demo held in memory. The demo is not copied as a
+    /// whole; each decoded message is copied once to the bit reader buffer.
+    /// @param data demo content, must stay valid until the demo is closed
+    bool openMemory(const void* data, size_t size, bool analysis = true);
+
     /// Checks whether a demo file is currently loaded.
     bool isOpen() const noexcept;
 
@@ -44,11 +78,17 @@ public:
     void close();
 
     /// Saves current content to a demo file, overwriting if necessary.
+    /// Only modified messages are encoded again (in parallel, see setSaveThreads),
+    /// others are copied from source.
     /// @param filename output path
     /// @param endSign append two consecutive -1 messages as terminator
     /// @return true if successful
     bool save(std::string_view filename, bool endSign = false) const;
 
+    /// Number of threads encoding modified messages in save().
+    /// @param count 0 means one per hardware thread, 1 encodes on calling thread only
+    void setSaveThreads(int count);
+
     /// Ensures message with given id is loaded into memory.
     void loadMessage(int id);
 
@@ -58,12 +98,35 @@ public:
     /// Unloads message with given id, keeping only metadata.
     void unloadMessage(int id);
 
+    /// True if message is loaded and was changed since (see Message::isModified).
+    bool isMessageModified(int id) const;
+
+    /// Reads message as stored in the source, without decoding it.
+    /// @return false if id is invalid or message cannot be read
+    bool readRawMessage(int id, DemoBlock& block) const;
+
     /// Performs analysis: map transitions, restarts, vehicle states.
     void analyse();
 
+    /// Decodes message header without loading it (see MessagePeek).
+    /// @return false if id is invalid or message cannot be read
+    bool peekMessage(int id, MessagePeek& peek) const;
+
     /// Returns pointer to a message (loads if not already loaded).
     Message* getMessage(int id);
 
+    /// Loads message and hands its ownership to the caller; the demo keeps
+    /// only metadata, as after unloadMessage(). Returns null on failure.
+    std::unique_ptr<Message> takeMessage(int id);
+
+    /// Lazy range over full snapshots of messages [first, last) (last < 0 means demo end).
+    /// Visited messages are unloaded. Usage: for (const Snapshot& s : demo.snapshots())
+    SnapshotRange snapshots(int first = 0, int last = -1) { return SnapshotRange(*this, first, last); }
+
+    /// Lazy range over server commands of messages [first, last) (last < 0 means demo end).
+    /// Visited messages are unloaded.
+    ServerCommandRange serverCommands(int first = 0, int last = -1) { return ServerCommandRange(*this, first, last); }
+
     /// Total number of messages in the demo.
     int getMessageCount() const;
 
@@ -0,0 +1,39 @@
+#ifndef DEMO_BLOCK_H
+#define DEMO_BLOCK_H
+
+#include <istream>
+#include <vector>
+#include <jka/defs.h>
+#include <jka/message.h>
+
+DEMO_NAMESPACE_START
+
+/**
+ * @brief Raw message as stored in a demo file: sequence number, length, data.
+ *
+ * Reading blocks only touches the file, decoding them only touches memory,
+ * so both steps can run on different threads.
+ */
+struct DemoBlock {
+    int               sequenceNumber;
+    int               length;
+    std::vector<byte> data;
+
+    DemoBlock() : sequenceNumber(-1), length(0) {}
+};
+
+/// Reads next block from stream (data buffer is reused).
+/// @return false at end marker, end of stream or truncated block
+bool readDemoBlock(std::istream& is, DemoBlock& block);
+
+/// Writes block framing and data to stream.
+void writeDemoBlock(std::ostream& os, const DemoBlock& block);
+
+/// Decodes block into an empty message. If decoding fails, it is retried
+/// with forced vehicle load, as Demo does before analysis.
+/// @return true if message was loaded
+bool decodeDemoBlock(Message& message, const DemoBlock& block);
+
+DEMO_NAMESPACE_END
+
+#endif // DEMO_BLOCK_H
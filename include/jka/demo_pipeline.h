@@ -0,0 +1,68 @@
+#ifndef DEMO_PIPELINE_H
+#define DEMO_PIPELINE_H
+
+#include <memory>
+#include <vector>
+#include <jka/demo.h>
+
+DEMO_NAMESPACE_START
+
+/**
+ * @brief Consumer plugged into a DemoPipeline.
+ *
+ * Messages and snapshots are shared between all analyzers of the pipeline,
+ * so they must be treated as read only.
+ */
+class DemoAnalyzer {
+public:
+    virtual ~DemoAnalyzer() {}
+
+    /// Called once before the first message.
+    virtual void begin() {}
+
+    /// Called for every decoded message, in order.
+    /// @param id message index in the demo
+    /// @param message decoded message
+    /// @param resolved full state of the message snapshot, or null when the
+    ///        message has no snapshot or its delta base was not received
+    virtual void onMessage(int id, const std::shared_ptr<Message>& message,
+        const std::shared_ptr<Snapshot>& resolved) = 0;
+
+    /// Called once after the last message.
+    virtual void end() {}
+};
+
+class DemoPipelineImpl;
+
+/**
+ * @brief Decodes each message once and dispatches it to many analyzers.
+ *
+ * Inline analyzers run on the decoding thread. Threaded analyzers get their
+ * own thread fed through a bounded queue; when a queue is full, decoding
+ * waits for that analyzer to catch up.
+ */
+class DemoPipeline {
+public:
+    explicit DemoPipeline(Demo& demo);
+    ~DemoPipeline();
+
+    DemoPipeline(const DemoPipeline&) = delete;
+    DemoPipeline& operator=(const DemoPipeline&) = delete;
+
+    /// Registers analyzer (not owned, must outlive run()).
+    /// @param threaded run analyzer on its own thread
+    /// @param queueCapacity messages buffered for a threaded analyzer
+    void addAnalyzer(DemoAnalyzer* analyzer, bool threaded = false, int queueCapacity = 64);
+
+    /// Decodes messages [first, last) and feeds all analyzers (last < 0 means demo end).
+    /// The first exception thrown by an analyzer stops decoding and the other
+    /// analyzers (end() is not called), it is rethrown once all threads are joined.
+    void run(int first = 0, int last = -1);
+
+private:
+    std::unique_ptr<DemoPipelineImpl> impl;
+};
+
+DEMO_NAMESPACE_END
+
+#endif // DEMO_PIPELINE_H
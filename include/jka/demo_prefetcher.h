@@ -0,0 +1,56 @@
+#ifndef DEMO_PREFETCHER_H
+#define DEMO_PREFETCHER_H
+
+#include <istream>
+#include <memory>
+#include <string>
+#include <jka/demo_block.h>
+
+DEMO_NAMESPACE_START
+
+class DemoPrefetcherImpl;
+
+/**
+ * @brief Reads and decodes messages ahead of the consumer.
+ *
+ * One thread reads raw blocks, a pool of threads decodes them and next()
+ * returns decoded messages in file order. Every decoding thread has its own
+ * pair of bounded blocking queues, blocks are dealt to them round robin.
+ */
+class DemoPrefetcher {
+public:
+    /// Reads from a file opened by the prefetcher.
+    explicit DemoPrefetcher(const std::string& filename);
+
+    /// Reads from given stream (not owned, must outlive the prefetcher).
+    explicit DemoPrefetcher(std::istream& is);
+
+    ~DemoPrefetcher();
+
+    DemoPrefetcher(const DemoPrefetcher&) = delete;
+    DemoPrefetcher& operator=(const DemoPrefetcher&) = delete;
+
+    /// Maximum number of blocks read ahead of the consumer (default 256).
+    void setReadAhead(int blocks);
+
+    /// Number of decoding threads, 0 uses all hardware threads (default).
+    void setDecodeThreads(int count);
+
+    /// Starts threads (called by first next() if not called before).
+    /// @return false if the file cannot be opened
+    bool start();
+
+    /// Next decoded message in file order, null at demo end.
+    /// Decoding errors are rethrown here, for the message that failed.
+    std::unique_ptr<Message> next();
+
+    /// Stops and joins all threads, remaining messages are dropped.
+    void stop();
+
+private:
+    std::unique_ptr<DemoPrefetcherImpl> impl;
+};
+
+DEMO_NAMESPACE_END
+
+#endif // DEMO_PREFETCHER_H
@@ -0,0 +1,125 @@
+#ifndef DEMO_RANGE_H
+#define DEMO_RANGE_H
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <jka/message.h>
+
+DEMO_NAMESPACE_START
+
+class Demo;
+class SnapshotResolver;
+
+/**
+ * @brief Lazy range over full snapshots of a demo, see Demo::snapshots().
+ *
+ * Messages are loaded one at a time and unloaded once visited, only the
+ * resolved snapshots of the delta window (PACKET_BACKUP) are kept alive.
+ * Messages that were already loaded (possibly edited) are left loaded.
+ * Snapshots whose delta base is missing are skipped.
+ */
+class SnapshotRange {
+public:
+    class iterator {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef Snapshot                value_type;
+        typedef std::ptrdiff_t          difference_type;
+        typedef const Snapshot*         pointer;
+        typedef const Snapshot&         reference;
+
+        iterator() : demo(0), id(0), last(0) {}
+
+        reference operator*() const { return *current; }
+        pointer operator->() const { return current.get(); }
+
+        iterator& operator++();
+
+        bool operator==(const iterator& other) const;
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+
+        /// Index of the message holding current snapshot.
+        int messageId() const { return id; }
+
+    private:
+        friend class SnapshotRange;
+
+        iterator(Demo* demo, int first, int last);
+        void advance();
+
+        Demo*                             demo;
+        int                               id;
+        int                               last;
+        std::shared_ptr<SnapshotResolver> resolver;
+        std::shared_ptr<Snapshot>         current;
+    };
+
+    SnapshotRange(Demo& demo, int first, int last) : demo(&demo), first(first), last(last) {}
+
+    iterator begin() const { return iterator(demo, first, last); }
+    iterator end() const { return iterator(); }
+
+private:
+    Demo* demo;
+    int   first;
+    int   last;
+};
+
+/**
+ * @brief Lazy range over server commands of a demo, see Demo::serverCommands().
+ *
+ * Only the message holding current command is loaded, it is unloaded when
+ * the iterator moves past it unless it was already loaded before.
+ */
+class ServerCommandRange {
+public:
+    class iterator {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef ServerCommand           value_type;
+        typedef std::ptrdiff_t          difference_type;
+        typedef const ServerCommand*    pointer;
+        typedef const ServerCommand&    reference;
+
+        iterator() : demo(0), id(0), last(0), instruction(0), current(0), loadedHere(false) {}
+
+        reference operator*() const { return *current; }
+        pointer operator->() const { return current; }
+
+        iterator& operator++();
+
+        bool operator==(const iterator& other) const;
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+
+        /// Index of the message holding current command.
+        int messageId() const { return id; }
+
+    private:
+        friend class ServerCommandRange;
+
+        iterator(Demo* demo, int first, int last);
+        void advance();
+
+        Demo*          demo;
+        int            id;
+        int            last;
+        int            instruction;
+        ServerCommand* current;
+        bool           loadedHere; //current message was loaded by this iterator
+    };
+
+    ServerCommandRange(Demo& demo, int first, int last) : demo(&demo), first(first), last(last) {}
+
+    iterator begin() const { return iterator(demo, first, last); }
+    iterator end() const { return iterator(); }
+
+private:
+    Demo* demo;
+    int   first;
+    int   last;
+};
+
+DEMO_NAMESPACE_END
+
+#endif // DEMO_RANGE_H
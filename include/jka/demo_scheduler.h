@@ -0,0 +1,94 @@
+#ifndef DEMO_SCHEDULER_H
+#define DEMO_SCHEDULER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <jka/demo.h>
+
+DEMO_NAMESPACE_START
+
+/**
+ * @brief Range of messages [first, last) that can be decoded independently.
+ *
+ * A segment always starts on a keyframe (gamestate or uncompressed snapshot)
+ * and no snapshot inside it is delta compressed against a message before it.
+ */
+struct DemoSegment {
+    int first;
+    int last;
+
+    DemoSegment(int first = 0, int last = 0) : first(first), last(last) {}
+
+    int size() const { return last - first; }
+};
+
+/**
+ * @brief User analysis run over one segment on a worker thread.
+ *
+ * One instance is created per segment, so implementations need no locking.
+ * Instances are handed back by DemoScheduler::run in segment order, which
+ * is where results of consecutive segments should be merged.
+ */
+class SegmentAnalyzer {
+public:
+    virtual ~SegmentAnalyzer() {}
+
+    /// Called before the first message of the segment.
+    virtual void begin(const DemoSegment& segment) { (void)segment; }
+
+    /// Called for every message of the segment, in order.
+    /// @param id message index in the demo
+    /// @param message decoded message (unloaded after the call)
+    /// @param resolved full state of the message snapshot, or null when the
+    ///        message has no snapshot or its delta base was not received
+    virtual void onMessage(int id, Message* message, Snapshot* resolved) = 0;
+
+    /// Called after the last message of the segment.
+    virtual void end() {}
+};
+
+/**
+ * @brief Splits a demo at keyframes and analyses the segments in parallel.
+ *
+ * Every worker opens its own Demo on the file, decodes and reconstructs
+ * its segments and feeds them to a fresh SegmentAnalyzer.
+ */
+class DemoScheduler {
+public:
+    typedef std::function<std::unique_ptr<SegmentAnalyzer>()> AnalyzerFactory;
+
+    explicit DemoScheduler(const std::string& filename);
+
+    /// Number of worker threads, 0 uses all hardware threads.
+    void setThreadCount(int count) { threadCount = count; }
+
+    /// Keyframes closer than this to the previous split are not used as split points.
+    void setMinSegmentLength(int count) { minSegmentLength = count; }
+
+    /// Peeks all messages and computes segments.
+    /// @return false if the demo cannot be opened
+    bool split();
+
+    /// Segments computed by split().
+    const std::vector<DemoSegment>& getSegments() const { return segments; }
+
+    /// Runs one analyzer per segment (calls split() if not done yet).
+    /// Exceptions thrown by workers are rethrown once all threads are joined.
+    /// @return analyzers in segment order
+    std::vector<std::unique_ptr<SegmentAnalyzer>> run(const AnalyzerFactory& factory);
+
+private:
+    void runSegment(Demo& demo, const DemoSegment& segment, SegmentAnalyzer& analyzer) const;
+
+    std::string              filename;
+    int                      threadCount;
+    int                      minSegmentLength;
+    bool                     splitted;
+    std::vector<DemoSegment> segments;
+};
+
+DEMO_NAMESPACE_END
+
+#endif // DEMO_SCHEDULER_H
@@ -0,0 +1,110 @@
+#ifndef DEMO_SOURCE_H
+#define DEMO_SOURCE_H
+
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <jka/defs.h>
+
+DEMO_NAMESPACE_START
+
+/**
+ * @brief Random access byte source a Demo reads from.
+ *
+ * Implement it to parse demos from custom storage. Sources backed by memory
+ * also implement view(), which lets Demo skip the intermediate read: message
+ * bytes are copied once, from the view to the bit reader buffer.
+ */
+class DemoSource {
+public:
+    virtual ~DemoSource() {}
+
+    /// Reads up to length bytes at current position.
+    /// @return number of bytes read (less than length at end of source)
+    virtual size_t read(void* dest, size_t length) = 0;
+
+    /// Moves current position, false if offset is past the end.
+    virtual bool seek(size_t offset) = 0;
+
+    /// Current position.
+    virtual size_t tell() const = 0;
+
+    /// Total size in bytes.
+    virtual size_t size() const = 0;
+
+    /// Pointer to bytes [offset, offset + length) valid as long as the source,
+    /// or null if the source is not memory backed.
+    virtual const byte* view(size_t offset, size_t length) const {
+        (void)offset; (void)length;
+        return 0;
+    }
+};
+
+/// Reads a file through std::ifstream.
+class FileSource : public DemoSource {
+public:
+    explicit FileSource(const std::string& filename);
+
+    bool isOpen() const { return file.is_open(); }
+
+    size_t read(void* dest, size_t length) override;
+    bool seek(size_t offset) override;
+    size_t tell() const override { return position; }
+    size_t size() const override { return length; }
+
+private:
+    std::ifstream file;
+    size_t        position;
+    size_t        length;
+};
+
+/// Reads from a memory span, either borrowed from the caller or owned.
+class MemorySource : public DemoSource {
+public:
+    /// Borrows data (zero-copy), it must outlive the source.
+    MemorySource(const void* data, size_t length);
+
+    /// Takes ownership of data.
+    explicit MemorySource(std::vector<byte> data);
+
+    size_t read(void* dest, size_t length) override;
+    bool seek(size_t offset) override;
+    size_t tell() const override { return position; }
+    size_t size() const override { return length; }
+    const byte* view(size_t offset, size_t length) const override;
+
+protected:
+    MemorySource() : data(0), length(0), position(0) {}
+
+    const byte*       data;
+    size_t            length;
+    size_t            position;
+    std::vector<byte> owned;
+};
+
+/// Maps a whole file into memory (POSIX only, see openDemoSource).
+class MmapSource : public MemorySource {
+public:
+    explicit MmapSource(const std::string& filename);
+    ~MmapSource();
+
+    MmapSource(const MmapSource&) = delete;
+    MmapSource& operator=(const MmapSource&) = delete;
+
+    bool isOpen() const { return mapping != 0; }
+
+private:
+    void* mapping;
+};
+
+/// Opens the best source for a file: mapped when the platform supports it,
+/// read through std::ifstream otherwise. gzip and zstd compressed files are
+/// decompressed transparently (see CompressedSource).
+/// Returns null if file cannot be opened.
+std::unique_ptr<DemoSource> openDemoSource(const std::string& filename);
+
+DEMO_NAMESPACE_END
+
+#endif // DEMO_SOURCE_H
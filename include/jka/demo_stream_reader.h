@@ -0,0 +1,55 @@
+#ifndef DEMO_STREAM_READER_H
+#define DEMO_STREAM_READER_H
+
+#include <istream>
+#include <memory>
+#include <jka/demo_block.h>
+#include <jka/snapshot_resolver.h>
+
+DEMO_NAMESPACE_START
+
+/**
+ * @brief Forward-only demo reader for streams that cannot seek (pipes, stdin, sockets).
+ *
+ * Unlike Demo, it builds no index: messages are decoded as they arrive and
+ * only the last PACKET_BACKUP of them (the delta window) are kept.
+ */
+class DemoStreamReader {
+public:
+    /// Reads from given stream (not owned), which must be in binary mode.
+    explicit DemoStreamReader(std::istream& is);
+
+    /// Reads and decodes next message.
+    /// @return message (owned by the reader, valid for the next PACKET_BACKUP
+    ///         calls), or null at demo end
+    Message* next();
+
+    /// True once end marker or end of stream was reached.
+    bool isEnd() const { return ended; }
+
+    /// Message with given sequence number, null if not in window.
+    Message* findMessage(int sequenceNumber) const;
+
+    /// Full snapshot of the last message read, null if it has none or its
+    /// delta base was not in window.
+    Snapshot* getSnapshot() const { return current.get(); }
+
+    /// Full snapshot of given sequence number, null if not in window.
+    Snapshot* findSnapshot(int sequenceNumber) const { return resolver.find(sequenceNumber).get(); }
+
+    /// Number of messages read so far.
+    int getMessageCount() const { return count; }
+
+private:
+    std::istream&             is;
+    DemoBlock                 block;
+    std::unique_ptr<Message>  window[PACKET_BACKUP];
+    SnapshotResolver          resolver;
+    std::shared_ptr<Snapshot> current;
+    int                       count;
+    bool                      ended;
+};
+
+DEMO_NAMESPACE_END
+
+#endif // DEMO_STREAM_READER_H
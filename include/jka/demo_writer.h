@@ -0,0 +1,48 @@
+#ifndef DEMO_WRITER_H
+#define DEMO_WRITER_H
+
+#include <ostream>
+#include <jka/demo_block.h>
+
+DEMO_NAMESPACE_START
+
+/**
+ * @brief Writes a demo message by message, mixing raw copies and encoded messages.
+ *
+ * A constant shift can be added to every sequence number written. Deltas
+ * refer to their base by sequence number difference, so shifted messages
+ * stay valid without being decoded.
+ */
+class DemoWriter {
+public:
+    /// Writes to given stream (not owned), which must be in binary mode.
+    explicit DemoWriter(std::ostream& os);
+
+    /// Value added to sequence numbers of following messages.
+    void setSequenceShift(int shift) { sequenceShift = shift; }
+    int getSequenceShift() const { return sequenceShift; }
+
+    /// Copies block as is, only its sequence number is shifted.
+    void writeBlock(const DemoBlock& block);
+
+    /// Encodes message, its sequence number is shifted in output only.
+    void writeMessage(const Message& message);
+
+    /// Appends two consecutive -1 as terminator.
+    void writeEnd();
+
+    /// Number of messages written so far.
+    int getMessageCount() const { return count; }
+
+    /// False once a write failed.
+    bool isGood() const { return os.good(); }
+
+private:
+    std::ostream& os;
+    int           sequenceShift;
+    int           count;
+};
+
+DEMO_NAMESPACE_END
+
+#endif // DEMO_WRITER_H
@@ -305,14 +305,69 @@ inline const char* to_cstr(EntityType t) {
 
 #pragma once
 #include <cstdint>
+#include <optional>
+#include <string_view>
 #include <nlohmann/json.hpp>
 
+#include "field_reflection.hpp"  // PerfectHash, leafScalar
 #include "Vec3.hpp"              // Vec3T<T>, Vec3, Vec3i
 #include "trajectory.hpp"        // Trajectory moderne
 #include "state.h"               // Définitions communes (legacy)
 
 namespace jka {
 
+/// Masque de champs "dirty" : un bit par champ (voir EntityField / PlayerField)
+using FieldMask = std::uint32_t;
+
+/// Descripteurs d’EntityState, dans l’ordre de déclaration : seule liste à
+/// tenir à jour. Les champs (masques dirty, comparaisons, fusions) et les
+/// feuilles (noms netfield "pos.trBase[0]"..., accès par nom, sérialiseurs
+/// de state_writers.hpp) en sont générés, voir field_reflection.hpp.
+#define JKA_ENTITYSTATE_DESCRIPTORS(D, X) \
+    D(X, SCALAR, number) D(X, SCALAR, eType) D(X, SCALAR, eFlags) \
+    D(X, TRAJECTORY, pos) D(X, TRAJECTORY, apos) \
+    D(X, VEC3, origin) D(X, VEC3, origin2) D(X, VEC3, angles) D(X, VEC3, angles2) \
+    D(X, SCALAR, time) D(X, SCALAR, time2) \
+    D(X, SCALAR, otherEntityNum) D(X, SCALAR, otherEntityNum2) \
+    D(X, SCALAR, groundEntityNum) D(X, SCALAR, loopSound) D(X, SCALAR, constantLight) \
+    D(X, SCALAR, modelindex) D(X, SCALAR, modelindex2) D(X, SCALAR, clientNum) \
+    D(X, SCALAR, frame) D(X, SCALAR, solid) D(X, SCALAR, event) D(X, SCALAR, eventParm) \
+    D(X, SCALAR, powerups) D(X, SCALAR, weapon) D(X, SCALAR, legsAnim) \
+    D(X, SCALAR, torsoAnim) D(X, SCALAR, generic1)
+
+/// X(champ) pour chaque champ
+#define JKA_ENTITYSTATE_FIELDS(X) JKA_ENTITYSTATE_DESCRIPTORS(JKA_FIELD_OF, X)
+
+/// Index de bit de chaque champ d’EntityState dans un FieldMask
+enum class EntityField : std::uint32_t {
+#define JKA_X(f) f,
+    JKA_ENTITYSTATE_FIELDS(JKA_X)
+#undef JKA_X
+    Count
+};
+static_assert(static_cast<std::uint32_t>(EntityField::Count) <= 32, "FieldMask trop petit pour EntityState");
+
+constexpr FieldMask fieldBit(EntityField f) noexcept { return FieldMask{1} << static_cast<std::uint32_t>(f); }
+constexpr FieldMask allEntityFields = (FieldMask{1} << static_cast<std::uint32_t>(EntityField::Count)) - 1;
+
+/// X(id, nom netfield, membre) pour chaque feuille
+#define JKA_ENTITYSTATE_LEAVES(X) JKA_ENTITYSTATE_DESCRIPTORS(JKA_LEAVES_OF, X)
+
+enum class EntityLeaf : int {
+#define JKA_X(id, name, member) id,
+    JKA_ENTITYSTATE_LEAVES(JKA_X)
+#undef JKA_X
+    Count
+};
+
+inline constexpr std::array<std::string_view, static_cast<std::size_t>(EntityLeaf::Count)> entityLeafNames{ {
+#define JKA_X(id, name, member) name,
+    JKA_ENTITYSTATE_LEAVES(JKA_X)
+#undef JKA_X
+} };
+
+inline constexpr PerfectHash<entityLeafNames.size()> entityLeafHash(entityLeafNames);
+
 /// État d’une entité dans un snapshot (équivalent entityState_t en C)
 struct EntityState {
     int number{0};       ///< Numéro unique de l’entité (slot)
@@ -352,6 +407,10 @@ struct EntityState {
 
     int generic1{0};
 
+    /// Champs portés par ce delta (0 = état complet). Ignoré par operator==
+    /// et par la sérialisation JSON ; n’a de sens que sur un snapshot delta.
+    FieldMask dirty{0};
+
     // ---- Helpers de conversion réseau/offline -----------------------------
 
     /// Retourne origin en flottant (offline/debug)
@@ -427,6 +486,76 @@ struct EntityState {
         j.at("generic1").get_to(s.generic1);
     }
 
+    // ---- Comparaison champ par champ ---------------------------------------
+
+    /// Masque des champs (parmi `within`) qui diffèrent entre a et b
+    friend FieldMask diffFields(const EntityState& a, const EntityState& b,
+                                FieldMask within = allEntityFields) noexcept {
+        FieldMask m = 0;
+#define JKA_X(f) \
+        if ((within & fieldBit(EntityField::f)) && !(a.f == b.f)) m |= fieldBit(EntityField::f);
+        JKA_ENTITYSTATE_FIELDS(JKA_X)
+#undef JKA_X
+        return m;
+    }
+
+    /// Copie dans dst les seuls champs de src sélectionnés par mask
+    friend void mergeFields(EntityState& dst, const EntityState& src, FieldMask mask) noexcept {
+#define JKA_X(f) \
+        if (mask & fieldBit(EntityField::f)) dst.f = src.f;
+        JKA_ENTITYSTATE_FIELDS(JKA_X)
+#undef JKA_X
+    }
+
+    friend bool operator==(const EntityState& a, const EntityState& b) noexcept {
+        return diffFields(a, b) == 0;
+    }
+    friend bool operator!=(const EntityState& a, const EntityState& b) noexcept { return !(a == b); }
+
+    // ---- Accès par feuille / nom netfield ----------------------------------
+
+    /// Valeur d’une feuille (les entiers sont exacts en double)
+    double getLeaf(EntityLeaf leaf) const noexcept {
+        switch (leaf) {
+#define JKA_X(id, name, member) case EntityLeaf::id: return leafScalar(member);
+        JKA_ENTITYSTATE_LEAVES(JKA_X)
+#undef JKA_X
+        default: return 0;
+        }
+    }
+
+    void setLeaf(EntityLeaf leaf, double value) noexcept {
+        switch (leaf) {
+#define JKA_X(id, name, member) case EntityLeaf::id: leafAssign(member, value); break;
+        JKA_ENTITYSTATE_LEAVES(JKA_X)
+#undef JKA_X
+        default: break;
+        }
+    }
+
+    /// Recherche O(1) par hachage parfait ("pos.trBase[0]", "weapon"...)
+    std::optional<double> getByNetfieldName(std::string_view name) const noexcept {
+        int leaf = entityLeafHash.find(name);
+        if (leaf < 0) return std::nullopt;
+        return getLeaf(static_cast<EntityLeaf>(leaf));
+    }
+
+    /// false si le nom n’est pas une feuille d’EntityState
+    bool setByNetfieldName(std::string_view name, double value) noexcept {
+        int leaf = entityLeafHash.find(name);
+        if (leaf < 0) return false;
+        setLeaf(static_cast<EntityLeaf>(leaf), value);
+        return true;
+    }
+
+    /// Appelle f(EntityLeaf, nom, valeur int|float) pour chaque feuille, dans l’ordre
+    template <typename F>
+    void forEachLeaf(F&& f) const {
+#define JKA_X(id, name, member) f(EntityLeaf::id, std::string_view(name), leafScalar(member));
+        JKA_ENTITYSTATE_LEAVES(JKA_X)
+#undef JKA_X
+    }
+
     // ---- Parsing depuis netfields (à compléter avec ton parser) ------------
     template <typename NetfieldMap>
     static EntityState makeFromNetfieldPairs(const NetfieldMap& fields) {
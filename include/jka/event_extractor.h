@@ -0,0 +1,99 @@
+#ifndef EVENT_EXTRACTOR_H
+#define EVENT_EXTRACTOR_H
+
+#include <functional>
+#include <vector>
+#include <jka/bg_defs.h>
+#include <jka/delta_resolver.h>
+#include <jka/demo.h>
+
+DEMO_NAMESPACE_START
+
+/// One entity or player state event, fired once as cgame would.
+struct GameEvent {
+    int  messageId;
+    int  serverTime;
+    int  entityNum;       ///< entity carrying event, client number for player state events and EF_PLAYER_EVENT temp entities
+    int  event;           ///< entity_event_t, sequence bits removed
+    int  eventParm;
+    int  otherEntityNum;  ///< 0 for player state events
+    int  otherEntityNum2;
+    bool temp;            ///< sent as temp entity (eType ET_EVENTS + event)
+    bool playerState;     ///< from recording player state
+};
+
+/// EV_OBITUARY
+struct Obituary {
+    int victim;
+    int killer;         ///< -1 for world or no killer
+    int meansOfDeath;
+};
+
+/// EV_ITEM_PICKUP, EV_GLOBAL_ITEM_PICKUP
+struct ItemPickup {
+    int  clientNum;     ///< -1 for global pickups, which do not tell
+    int  item;          ///< bg_itemlist index
+    bool global;
+};
+
+/// EV_SABER_HIT, EV_PAIN
+struct Hit {
+    int  victim;
+    int  attacker;      ///< -1 when unknown (pain)
+    int  health;        ///< victim health after pain, -1 for saber hits
+    bool saber;
+};
+
+bool toObituary(const GameEvent& event, Obituary& obituary);
+bool toItemPickup(const GameEvent& event, ItemPickup& pickup);
+bool toHit(const GameEvent& event, Hit& hit);
+
+/**
+ * @brief Streams entity events of a demo in one pass.
+ *
+ * Snapshots are resolved through a DeltaResolver tracking only the fields
+ * events need. New events are detected with cgame rules (CG_CheckEvents,
+ * CG_CheckPlayerstateEvents):
+ * - an entity event fires when event changes, EV_EVENT_BITS making repeats
+ *   of one event differ
+ * - a temp entity fires once when it appears
+ * - an entity back after EVENT_VALID_MSEC or more may fire its event again
+ * - player state events fire by eventSequence, external event on change
+ */
+class EventExtractor {
+public:
+    typedef std::function<void(const GameEvent&)> Listener;
+
+    explicit EventExtractor(Listener listener);
+
+    /// Forgets frames and entity history.
+    void reset();
+
+    /// Feeds a decoded message, messages must come in order.
+    void update(int messageId, Message* message);
+
+    /// Feeds all messages of demo, decoding them without loading them in demo.
+    /// @return false if a message cannot be read
+    bool run(const Demo& demo);
+
+private:
+    struct EntityHistory {
+        int previousEvent;
+        int lastSeen;       //server time entity was last in a frame
+        int lastFrame;      //frame count then
+    };
+
+    void checkEntities(int messageId, const DeltaResolver::Frame& frame);
+    void checkPlayerState(int messageId, const DeltaResolver::Frame& frame);
+    void fire(const GameEvent& event);
+
+    Listener                   listener;
+    DeltaResolver              resolver;
+    std::vector<EntityHistory> entities;      //MAX_GENTITIES
+    std::vector<int>           previousPlayer;
+    int                        frameCount;     //frames checked since reset
+};
+
+DEMO_NAMESPACE_END
+
+#endif // EVENT_EXTRACTOR_H
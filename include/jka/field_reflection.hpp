@@ -0,0 +1,105 @@
+#pragma once
+// jka/field_reflection.hpp — Outils communs aux descripteurs de champs
+// (X-macros JKA_*_DESCRIPTORS d’EntityState / PlayerState)
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+/// Une liste de descripteurs JKA_*_DESCRIPTORS(D, X) appelle D(X, forme, champ)
+/// pour chaque champ. La forme donne ses feuilles (valeurs scalaires nommées
+/// comme dans la table netfield) ; champs et feuilles en sont dérivés :
+///   JKA_FIELD_OF  -> X(champ)                  (masques dirty)
+///   JKA_LEAVES_OF -> X(id, "nom", membre)...   (accès par nom, sérialiseurs)
+#define JKA_FIELD_OF(X, shape, f) X(f)
+#define JKA_LEAVES_OF(X, shape, f) JKA_LEAVES_##shape(X, f)
+
+#define JKA_LEAVES_SCALAR(X, f) X(f, #f, f)
+#define JKA_LEAVES_VEC3(X, f) \
+    X(f##_0, #f "[0]", f.x) X(f##_1, #f "[1]", f.y) X(f##_2, #f "[2]", f.z)
+#define JKA_LEAVES_TRAJECTORY(X, f) \
+    X(f##_trType, #f ".trType", f.type) \
+    X(f##_trTime, #f ".trTime", f.startTime) \
+    X(f##_trDuration, #f ".trDuration", f.duration) \
+    X(f##_trBase_0, #f ".trBase[0]", f.base.x) \
+    X(f##_trBase_1, #f ".trBase[1]", f.base.y) \
+    X(f##_trBase_2, #f ".trBase[2]", f.base.z) \
+    X(f##_trDelta_0, #f ".trDelta[0]", f.delta.x) \
+    X(f##_trDelta_1, #f ".trDelta[1]", f.delta.y) \
+    X(f##_trDelta_2, #f ".trDelta[2]", f.delta.z)
+#define JKA_LEAVES_COLLECTION(X, f) // pas de feuille scalaire
+
+namespace jka {
+
+/// FNV-1a 32 bits, évaluable à la compilation
+constexpr std::uint32_t fnv1a(std::string_view s, std::uint32_t seed) noexcept {
+    std::uint32_t h = 2166136261u ^ seed;
+    for (char c : s) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/// Hachage parfait d’un ensemble fixe de noms, construit à la compilation.
+/// La graine est cherchée jusqu’à ce qu’aucun nom ne partage d’alvéole :
+/// une recherche coûte un hachage et une comparaison de chaîne.
+template <std::size_t N>
+class PerfectHash {
+public:
+    /// Puissance de 2 >= 8N : peu de graines à essayer
+    static constexpr std::size_t Size = [] {
+        std::size_t size = 1;
+        while (size < 8 * N) size <<= 1;
+        return size;
+    }();
+
+    constexpr explicit PerfectHash(const std::array<std::string_view, N>& names)
+        : names_(names), seed_(0), slots_{} {
+        while (!build()) ++seed_;
+    }
+
+    /// Index du nom dans le tableau d’origine, -1 s’il est inconnu
+    constexpr int find(std::string_view name) const noexcept {
+        int i = slots_[fnv1a(name, seed_) & (Size - 1)];
+        return (i >= 0 && names_[i] == name) ? i : -1;
+    }
+
+    constexpr std::uint32_t seed() const noexcept { return seed_; }
+
+private:
+    constexpr bool build() {
+        for (std::size_t i = 0; i < Size; ++i) slots_[i] = -1;
+
+        for (std::size_t i = 0; i < N; ++i) {
+            std::size_t slot = fnv1a(names_[i], seed_) & (Size - 1);
+            if (slots_[slot] >= 0) return false;
+            slots_[slot] = static_cast<std::int16_t>(i);
+        }
+        return true;
+    }
+
+    std::array<std::string_view, N> names_;
+    std::uint32_t                   seed_;
+    std::array<std::int16_t, Size>  slots_;
+};
+
+/// Valeur d’une feuille telle qu’écrite par les sérialiseurs :
+/// float pour les flottants, int pour les entiers et les énumérations
+template <typename T>
+constexpr auto leafScalar(T v) noexcept {
+    if constexpr (std::is_floating_point_v<T>) return static_cast<float>(v);
+    else if constexpr (std::is_enum_v<T>) return static_cast<int>(static_cast<std::underlying_type_t<T>>(v));
+    else return static_cast<int>(v);
+}
+
+/// Affectation d’une feuille depuis une valeur générique
+template <typename T, typename V>
+constexpr void leafAssign(T& dst, V v) noexcept {
+    if constexpr (std::is_enum_v<T>) dst = static_cast<T>(static_cast<std::underlying_type_t<T>>(v));
+    else dst = static_cast<T>(v);
+}
+
+} // namespace jka
@@ -0,0 +1,53 @@
+#ifndef INFO_STRING_H
+#define INFO_STRING_H
+
+#include <string_view>
+#include <vector>
+#include <jka/defs.h>
+
+DEMO_NAMESPACE_START
+
+/**
+ * @brief Hashed key index over an info string ("\key\value\key\value").
+ *
+ * The string is tokenized once; key lookups are then O(1) and never
+ * allocate. Keys compare case insensitively, as Info_ValueForKey does.
+ * Returned views point into indexed string, which must outlive the index.
+ */
+class InfoStringView {
+public:
+    InfoStringView() {}
+    explicit InfoStringView(std::string_view info) { parse(info); }
+
+    /// Indexes new string, forgetting previous one.
+    void parse(std::string_view info);
+
+    /// Value of key, empty if key is missing.
+    std::string_view value(std::string_view key) const;
+
+    /// True if key is present (even with empty value).
+    bool contains(std::string_view key) const { return find(key) >= 0; }
+
+    /// Number of key/value pairs.
+    int size() const { return (int)entries.size(); }
+
+    /// Pairs in string order.
+    std::string_view keyAt(int i) const { return entries[i].key; }
+    std::string_view valueAt(int i) const { return entries[i].value; }
+
+private:
+    struct Entry {
+        std::string_view key;
+        std::string_view value;
+    };
+
+    static unsigned hash(std::string_view key);
+    int find(std::string_view key) const;
+
+    std::vector<Entry> entries;
+    std::vector<int>   slots; //open addressing, entry index + 1, 0 when empty
+};
+
+DEMO_NAMESPACE_END
+
+#endif // INFO_STRING_H
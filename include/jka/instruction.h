@@ -227,9 +227,12 @@ DEMO_NAMESPACE_END
 #include <jka/defs.h>
 #include <jka/state.h>
 #include <jka/messagebuffer.h>
+#include <jka/string_arena.h>
+#include <jka/info_string.h>
 
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <ostream>
@@ -253,7 +256,7 @@ enum InstrTypes {
 // Pré-déclarations pour conversions typées
 class Gamestate;
 class MapChange;
-class Snapshot;      // <— défini dans snapshot.hpp
+class Snapshot;      // hérité ; le snapshot décodé moderne est jka::Snapshot (snapshot.hpp)
 class ServerCommand;
 
 /**
@@ -262,6 +265,7 @@ class ServerCommand;
 class Instruction {
 protected:
     int type;
+    bool modified{false};
 
     // Map des entités utilisée par plusieurs instructions
 protected:
@@ -281,6 +285,10 @@ public:
     // Accès
     int getType() const noexcept { return type; }
 
+    // Modifiée depuis le chargement (Demo::save ne réencode que ces messages)
+    virtual bool isModified() const noexcept { return modified; }
+    virtual void setModified(bool value) noexcept { modified = value; }
+
     // Conversions dynamiques (compat héritée)
     MapChange*     getMapChange()     { return dynamic_cast<MapChange*>(this); }
     Gamestate*     getGamestate()     { return dynamic_cast<Gamestate*>(this); }
@@ -306,7 +314,7 @@ public:
 
     // Accès modernes
     const std::string& getMapChange() const noexcept { return mapChange; }
-    void setMapChange(const std::string& map) { mapChange = map; }
+    void setMapChange(const std::string& map) { mapChange = map; modified = true; }
 };
 
 /**
@@ -314,23 +322,93 @@ public:
  */
 class ServerCommand : public Instruction {
 private:
-    int         sequenceNumber {0};
-    std::string command;
+    int              sequenceNumber {0};
+    std::string_view command;          // texte décodé, dans l'arène du message
+    std::string      edited;           // possédé seulement après modification
+    bool             isEdited {false};
 
 public:
     ServerCommand() : Instruction(INSTR_SERVERCOMMAND) {}
+    // Une copie possède son texte : elle survit au message d'origine
+    ServerCommand(const ServerCommand& other);
+    ServerCommand& operator=(const ServerCommand& other);
 
     // I/O
     void Save() const override;
     void Load() override;
     void report(std::ostream& os) const override;
 
-    // Accès
+    // Accès (vue valide tant que l'instruction et son message existent)
     int getSequenceNumber() const noexcept { return sequenceNumber; }
-    const std::string& getCommand() const noexcept { return command; }
+    std::string_view getCommand() const noexcept { return isEdited ? std::string_view(edited) : command; }
 
-    void setSequenceNumber(int seq) noexcept { sequenceNumber = seq; }
-    void setCommand(const std::string& cmd) { command = cmd; }
+    void setSequenceNumber(int seq) noexcept { sequenceNumber = seq; modified = true; }
+    void setCommand(std::string_view cmd) { edited = cmd; isEdited = true; modified = true; }
+};
+
+/**
+ * Snapshot hérité (réseau) : playerstate, vehiclestate et entités d'un message.
+ * Tout setter marque l'instruction modifiée ; isModified() tient aussi compte
+ * des états contenus.
+ */
+class Snapshot : public Instruction {
+protected:
+    int serverTime {0};
+    int deltaNum {0};
+    int flags {0};
+    std::vector<byte> areaMask;
+
+    PlayerState* playerState {nullptr};
+    PlayerState* vehicleState {nullptr};
+    entitymap entities;
+
+    Snapshot(const Snapshot&) = default;   // réservé à clone() (copie profonde des états)
+
+public:
+    Snapshot() : Instruction(INSTR_SNAPSHOT) {}
+    ~Snapshot() override;
+
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    Snapshot* clone();
+
+    // I/O
+    void Save() const override;
+    void Load() override;
+    void report(std::ostream& os) const override;
+
+    // Suivi des modifications (inclut playerstate, vehiclestate et entités)
+    bool isModified() const noexcept override;
+    void setModified(bool value) noexcept override;
+
+    // Accès
+    int getAreamaskLen() const noexcept { return static_cast<int>(areaMask.size()); }
+    int getAreamask(int id) const { return static_cast<int>(areaMask.at(id)); }
+    int getDeltanum() const noexcept { return deltaNum; }
+    int getServertime() const noexcept { return serverTime; }
+    int getSnapflags() const noexcept { return flags; }
+    PlayerState* getPlayerstate() noexcept { return playerState; }
+    PlayerState* getVehiclestate() noexcept { return vehicleState; }
+    const PlayerState* getPlayerstate() const noexcept { return playerState; }
+    const PlayerState* getVehiclestate() const noexcept { return vehicleState; }
+
+    void setAreamask(int id, int value) { areaMask.at(id) = static_cast<byte>(value); modified = true; }
+    void setAreamaskLen(int value) { areaMask.resize(static_cast<size_t>(value)); modified = true; }
+    void setSnapflags(int value) noexcept { flags = value; modified = true; }
+    void setDeltanum(int value) noexcept { deltaNum = value; modified = true; }
+    void setServertime(int value) noexcept { serverTime = value; modified = true; }
+
+    // Snapshot non compressé : retire les valeurs nulles / inchangées
+    void makeInit();
+    void removeNotChanged();
+
+    // Découpe (compat héritée)
+    void applyOn(Snapshot* snap);
+    void delta(Snapshot* snap);
+
+    // Accès direct aux entités (optimiseur) : l'accès mutable marque le snapshot modifié
+    entitymap& getEntities() noexcept { modified = true; return entities; }
+    const entitymap& getEntities() const noexcept { return entities; }
 };
 
 /**
@@ -343,7 +421,7 @@ class Gamestate : public Instruction {
     };
 
 protected:
-    using stringmap    = std::map<int, std::string>;
+    using stringmap    = std::map<int, std::string_view>;
     using stringmap_it = stringmap::iterator;
     using stringmap_cit= stringmap::const_iterator;
 
@@ -355,28 +433,38 @@ protected:
     int                    magicSeed{0};
     std::vector<MagicData> magicData;
 
-    entitymap baseEntities;
-    stringmap configStrings;
+    entitymap                    baseEntities;
+    stringmap                    configStrings; // décodées : dans l'arène du message
+    std::shared_ptr<StringArena> edits;         // modifiées : chaque copie possède les siennes
+
+    mutable std::map<int, InfoStringView> infoCache; // invalidé à chaque modification
 
 public:
     Gamestate() : Instruction(INSTR_GAMESTATE) {}
+    // Une copie recopie ses configstrings dans sa propre arène `edits`
+    Gamestate(const Gamestate& other);
+    Gamestate& operator=(const Gamestate& other);
 
     // I/O
     void Save() const override;
     void Load() override;
     void report(std::ostream& os) const override;
 
-    // Accès
-    std::string getConfigstring(int id) const;
+    // Accès (vues valides tant que l'instruction et son message existent ;
+    // Load hors message et copies possèdent leurs chaînes)
+    std::string_view getConfigstring(int id) const;
+    // Configstring lue comme info string, en cache jusqu'à sa modification (non thread-safe)
+    const InfoStringView& getConfigstringInfo(int id) const;
     const std::string& getMagicStuff() const noexcept { return magicStuff; }
     int  getMagicSeed()  const noexcept { return magicSeed; }
     int  getMagicDataCount() const noexcept { return static_cast<int>(magicData.size()); }
     void getMagicData(unsigned id, int* byte1, int* byte2, int* int1, int* int2) const;
 
-    void setConfigstring(int id, const std::string& s);
-    void setMagicStuff(const std::string& s) { magicStuff = s; }
-    void setMagicSeed(int seed) noexcept { magicSeed = seed; }
+    void setConfigstring(int id, std::string_view s);
+    void setMagicStuff(const std::string& s) { magicStuff = s; modified = true; }
+    void setMagicSeed(int seed) noexcept { magicSeed = seed; modified = true; }
     void setMagicData(unsigned id, int byte1, int byte2, int int1, int int2);
+    void setCommandSequence(int sequence) noexcept { commandSequence = sequence; modified = true; }
 
     void removeConfigstring(int id);
 
@@ -394,7 +482,7 @@ public:
 
 DEMO_NAMESPACE_END
 
-// NOTE IMPORTANTE : la classe Snapshot est déplacée dans snapshot.hpp.
-// Inclure <jka/snapshot.hpp> dans les TU qui manipulent Snapshot.
+// NOTE : le snapshot décodé moderne est jka::Snapshot (<jka/snapshot.hpp>) ;
+// DemoJKA::Snapshot ci-dessus reste l'instruction réseau héritée.
 
 #endif // INSTRUCTION_H
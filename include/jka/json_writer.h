@@ -0,0 +1,89 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+#include <jka/defs.h>
+#include <jka/message.h>
+
+DEMO_NAMESPACE_START
+
+/**
+ * @brief Streaming JSON writer over a large output buffer.
+ *
+ * Values go straight to the buffer, which is written to the stream when
+ * full, so memory does not depend on document size. Numbers are formatted
+ * with std::to_chars (shortest round trip for floats, non finite ones as
+ * null). String bytes outside ASCII are written as \u00XX, demo text being
+ * Latin-1 rather than UTF-8.
+ *
+ * Commas are added by the writer, only structure has to be given:
+ *
+ *     json.beginObject();
+ *     json.key("serverTime");
+ *     json.value(1200);
+ *     json.endObject();
+ *     json.newline();
+ */
+class JsonWriter {
+public:
+    explicit JsonWriter(std::ostream& os, size_t bufferSize = 1 << 20);
+    ~JsonWriter(); //flushes
+
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    /// Member name, value must follow.
+    void key(std::string_view name);
+    /// Number used as member name (entity numbers, configstring indexes).
+    void key(int name);
+
+    void value(int v);
+    void value(std::int64_t v);
+    void value(float v);
+    void value(bool v);
+    void value(std::string_view v);
+    void value(const char* v) { value(std::string_view(v)); }
+    void null();
+
+    /// Ends a top level value, one per line for NDJSON.
+    void newline();
+
+    /// Writes buffer to stream. Returns false on stream error.
+    bool flush();
+
+private:
+    void separator();
+    void put(char c);
+    void put(std::string_view s);
+    void putNumber(std::int64_t v);
+    void putString(std::string_view s);
+
+    std::ostream&     os;
+    std::vector<char> buffer;
+    size_t            used;
+    bool              needComma;
+};
+
+/**
+ * Writes message as one JSON object:
+ *
+ *     {"index": i, "sequence": n, "instructions": [...]}
+ *
+ * Instructions hold a "type" (gamestate, server_command, snapshot,
+ * map_change) and their content. Entity and player states list the
+ * attributes sent in message only, by netfield name; snapshots are not
+ * resolved against their delta base.
+ */
+void writeMessageJson(JsonWriter& json, Message& message, int index);
+
+DEMO_NAMESPACE_END
+
+#endif // JSON_WRITER_H
@@ -1,81 +1,61 @@
 #pragma once
-#include <string>
-#include <vector>
+#include <istream>
+#include <ostream>
 #include <fstream>
-#include <memory>
+#include <jka/defs.h>
 #include <jka/messagebuffer.h>
-#include <jka/huffman.hpp>
+#include <jka/instruction.h>
 
-namespace DemoJKA {
+DEMO_NAMESPACE_START
 
+class MessageImpl;
+class StringArena;
+
+//one demo message: header (sequence number, reliable acknowledge) and the
+//decoded instruction list, which the message owns
 class Message {
 public:
-    Message(size_t maxSize = 16384)
-        : buffer(maxSize), huffStream(std::make_shared<HuffmanStream>()) {}
-
-    void clear() {
-        buffer.clear();
-    }
-
-    // --- Raw read/write ---
-    void writeBytes(const void* src, size_t length) {
-        buffer.writeBytes(src, length);
-    }
-
-    void readBytes(void* dest, size_t length) {
-        buffer.readBytes(dest, length);
-    }
-
-    // --- Huffman streaming read/write ---
-    void writeHuffBytes(const uint8_t* src, size_t length) {
-        buffer.huffTransmit(*huffStream, src, length, buffer.size());
-    }
-
-    void readHuffBytes(uint8_t* dest, size_t length) {
-        buffer.huffReceive(*huffStream, dest, length, buffer.size() - length);
-    }
-
-    void writeHuffByte(uint8_t value) {
-        buffer.writeByteHuff(*huffStream, value);
-    }
+    Message();
+    ~Message();
 
-    uint8_t readHuffByte() {
-        return buffer.readByteHuff(*huffStream);
-    }
+    Message(const Message&) = delete;
+    Message& operator=(const Message&) = delete;
 
-    // --- File I/O (raw, no Huffman) ---
-    bool loadFromFile(const std::string& filename) {
-        std::ifstream in(filename, std::ios::binary);
-        if (!in) return false;
+    //decoding scratch state, per thread (see message.cc)
+    static thread_local bool forceVehicleLoad;
+    static thread_local MessageBuffer buffer;
+    static thread_local StringArena* strings; //arena of the message being decoded, null otherwise
 
-        buffer.clear();
-        std::vector<uint8_t> tmp((std::istreambuf_iterator<char>(in)),
-                                 std::istreambuf_iterator<char>());
-        if (tmp.size() > buffer.capacity()) return false;
+    //I/O methods
+    void load(std::istream& is);
+    void load(int sequenceNumber, const byte* data, int length); //data without the file header
+    void save(std::ostream& os) const;
+    bool saveMessage(std::ofstream& os) const;
 
-        buffer.writeBytes(tmp.data(), tmp.size());
-        return true;
-    }
+    bool isLoad() const;
 
-    bool saveToFile(const std::string& filename) const {
-        std::ofstream out(filename, std::ios::binary);
-        if (!out) return false;
+    //modification tracking: true once the header, the instruction list or any
+    //instruction changed since load; Demo::save copies clean messages verbatim
+    bool isModified() const;
+    void setModified(bool value);
 
-        out.write(reinterpret_cast<const char*>(buffer.buffer()), buffer.size());
-        return true;
-    }
+    //get methods
+    int getSeqNumber() const;
+    int getRelAcknowledge() const;
+    Instruction* getInstruction(int id);
+    int getInstructionsCount() const;
 
-    // --- Accessors ---
-    size_t size() const { return buffer.size(); }
-    const uint8_t* data() const { return buffer.buffer(); }
-    bool overflowed() const { return buffer.isOverflowed(); }
+    //set methods
+    void setSeqNumber(int seq);
+    void setRelAcknowledge(int rel);
 
-    // Huffman stream accessor (for external reuse)
-    std::shared_ptr<HuffmanStream> getHuffStream() { return huffStream; }
+    //instruction list editing, the message takes ownership of inserted instructions
+    void deleteInstruction(int id, int n = 1);
+    void insertInstruction(int id, Instruction* instruction);
+    void clear();
 
 private:
-    MessageBuffer buffer;
-    std::shared_ptr<HuffmanStream> huffStream; // shared so state can persist across messages if desired
+    MessageImpl* impl;
 };
 
-} // namespace DemoJKA
+DEMO_NAMESPACE_END
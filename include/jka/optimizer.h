@@ -0,0 +1,65 @@
+#ifndef DEMO_OPTIMIZER_H
+#define DEMO_OPTIMIZER_H
+
+#include <jka/demo.h>
+
+DEMO_NAMESPACE_START
+
+/// What DemoOptimizer::run() changed.
+struct OptimizerStats {
+    int keyframesConverted = 0; ///< uncompressed snapshots stored as deltas
+    int snapshotsRebased = 0;   ///< deltas moved to previous message
+    int entitiesDropped = 0;    ///< entity entries without any change
+    int commandsDropped = 0;    ///< server commands already sent before
+};
+
+/**
+ * @brief Rewrites delta chains of a demo to make it smaller, keeping it playable.
+ *
+ * - uncompressed snapshots are stored as deltas against previous message,
+ *   except the first one after each gamestate
+ * - optionally, every delta is moved to previous message, which is the
+ *   closest base (servers delta against last acknowledged frame)
+ * - entity entries which change nothing are dropped
+ * - server commands resent until acknowledged are kept only once
+ *
+ * Messages are changed in place, call Demo::save afterwards. Changed messages
+ * stay loaded, others are unloaded once visited, unless they were loaded before.
+ *
+ * Note that converted keyframes are no longer places where decoding can
+ * start (see MessagePeek::isKeyframe, DemoScheduler).
+ */
+class DemoOptimizer {
+public:
+    explicit DemoOptimizer(Demo& demo);
+
+    /// Store uncompressed snapshots as deltas (default true).
+    void setDeltaKeyframes(bool value) { deltaKeyframes = value; }
+
+    /// Move every delta to previous message (default false, re-encodes all snapshots).
+    void setRebaseDeltas(bool value) { rebaseDeltas = value; }
+
+    /// Drop entity entries without change (default true).
+    void setDropEntities(bool value) { dropEntities = value; }
+
+    /// Drop server commands already sent in earlier messages (default true).
+    void setDropCommands(bool value) { dropCommands = value; }
+
+    /// Optimizes all messages of demo.
+    /// Throws DemoException if a message cannot be loaded.
+    void run();
+
+    const OptimizerStats& getStats() const { return stats; }
+
+private:
+    Demo&          demo;
+    bool           deltaKeyframes;
+    bool           rebaseDeltas;
+    bool           dropEntities;
+    bool           dropCommands;
+    OptimizerStats stats;
+};
+
+DEMO_NAMESPACE_END
+
+#endif // DEMO_OPTIMIZER_H
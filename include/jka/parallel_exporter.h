@@ -0,0 +1,78 @@
+#ifndef PARALLEL_EXPORTER_H
+#define PARALLEL_EXPORTER_H
+
+#include <ostream>
+#include <string>
+#include <jka/demo.h>
+
+DEMO_NAMESPACE_START
+
+enum ExportFormat {
+    EXPORT_NDJSON = 0, ///< one writeMessageJson object per line
+    EXPORT_CSV         ///< one row per sent value, see ParallelExporter
+};
+
+/**
+ * @brief Formats messages on worker threads, writes them in demo order.
+ *
+ * The calling thread reads raw messages and hands them out by chunks.
+ * Workers decode and format their chunk into a buffer (and compress it),
+ * a writer thread emits buffers in chunk order. Chunks in flight are
+ * bounded, so memory does not grow with the demo.
+ *
+ * Messages are formatted as they are sent, snapshots are not resolved, so
+ * every message is independent of the others.
+ *
+ * CSV columns are message, sequence, serverTime, type, number, field,
+ * value, with type one of:
+ * - gamestate: number is client number, value command sequence
+ * - configstring: number is index, value text
+ * - baseline / entity: number is entity, one row per attribute (entity
+ *   removal as field "removed")
+ * - player / vehicle: one row per attribute, arrays as "stats[N]" etc.
+ * - snapshot: value is deltaNum
+ * - command: number is sequence, value text
+ * - map_change: value is map
+ *
+ * With compression, every chunk is an independent zstd frame; the output
+ * is a regular zstd stream.
+ */
+class ParallelExporter {
+public:
+    explicit ParallelExporter(const Demo& demo);
+
+    void setFormat(ExportFormat value) { format = value; }
+
+    /// Number of worker threads, 0 uses all hardware threads.
+    void setThreadCount(int count) { threadCount = count; }
+
+    /// Messages formatted by a worker at once.
+    void setChunkSize(int messages) { chunkSize = messages > 0 ? messages : 1; }
+
+    /// zstd level of output, 0 writes plain text.
+    /// Throws DemoException if this build has no zstd.
+    void setCompression(int level);
+
+    /// True if this build can compress output.
+    static bool isCompressionSupported();
+
+    /// Exports messages [first, last) (last < 0 means demo end).
+    /// Exceptions thrown by workers (message that cannot be decoded) are
+    /// rethrown once all threads are joined.
+    /// @return false if a message cannot be read or stream fails
+    bool write(std::ostream& os, int first = 0, int last = -1);
+
+    /// Exports whole demo to file.
+    bool write(const std::string& filename);
+
+private:
+    const Demo&  demo;
+    ExportFormat format;
+    int          threadCount;
+    int          chunkSize;
+    int          compression;
+};
+
+DEMO_NAMESPACE_END
+
+#endif // PARALLEL_EXPORTER_H
@@ -6,14 +6,63 @@
 #include <string>
 #include <unordered_map>
 #include <optional>
+#include <string_view>
+#include <utility>
 #include <nlohmann/json.hpp>
 
+#include "jka/field_reflection.hpp" // PerfectHash, leafScalar
 #include "jka/Vec3.hpp"        // Vec3T<T>, Vec3, Vec3i
 #include "jka/trajectory.hpp"  // pour cohérence (même si Trajectory pas utilisé ici)
 #include "jka/netfields.hpp"   // pour NetField defs éventuelles
 
 namespace jka {
 
+/// Masque de champs "dirty" : un bit par champ (voir PlayerField)
+using FieldMask = std::uint32_t;
+
+/// Descripteurs de PlayerState, dans l’ordre de déclaration (voir
+/// JKA_ENTITYSTATE_DESCRIPTORS). Les collections n’ont pas de feuille.
+#define JKA_PLAYERSTATE_DESCRIPTORS(D, X) \
+    D(X, SCALAR, commandTime) D(X, SCALAR, pm_type) D(X, SCALAR, weapon) \
+    D(X, SCALAR, groundEntityNum) D(X, SCALAR, legsAnim) D(X, SCALAR, torsoAnim) \
+    D(X, SCALAR, eFlags) D(X, SCALAR, externalEvent) D(X, SCALAR, clientNum) D(X, SCALAR, ping) \
+    D(X, VEC3, origin) D(X, VEC3, velocity) D(X, VEC3, viewangles) \
+    D(X, COLLECTION, stats) D(X, COLLECTION, persistant) D(X, COLLECTION, ammo) \
+    D(X, COLLECTION, powerups) D(X, COLLECTION, extras)
+
+/// X(champ) pour chaque champ
+#define JKA_PLAYERSTATE_FIELDS(X) JKA_PLAYERSTATE_DESCRIPTORS(JKA_FIELD_OF, X)
+
+/// Index de bit de chaque champ de PlayerState dans un FieldMask
+enum class PlayerField : std::uint32_t {
+#define JKA_X(f) f,
+    JKA_PLAYERSTATE_FIELDS(JKA_X)
+#undef JKA_X
+    Count
+};
+static_assert(static_cast<std::uint32_t>(PlayerField::Count) <= 32, "FieldMask trop petit pour PlayerState");
+
+constexpr FieldMask fieldBit(PlayerField f) noexcept { return FieldMask{1} << static_cast<std::uint32_t>(f); }
+constexpr FieldMask allPlayerFields = (FieldMask{1} << static_cast<std::uint32_t>(PlayerField::Count)) - 1;
+
+/// X(id, nom netfield, membre) pour chaque feuille scalaire
+#define JKA_PLAYERSTATE_LEAVES(X) JKA_PLAYERSTATE_DESCRIPTORS(JKA_LEAVES_OF, X)
+
+enum class PlayerLeaf : int {
+#define JKA_X(id, name, member) id,
+    JKA_PLAYERSTATE_LEAVES(JKA_X)
+#undef JKA_X
+    Count
+};
+
+inline constexpr std::array<std::string_view, static_cast<std::size_t>(PlayerLeaf::Count)> playerLeafNames{ {
+#define JKA_X(id, name, member) name,
+    JKA_PLAYERSTATE_LEAVES(JKA_X)
+#undef JKA_X
+} };
+
+inline constexpr PerfectHash<playerLeafNames.size()> playerLeafHash(playerLeafNames);
+
 /// PlayerState moderne (équivalent `playerState_t` dans q_shared.h, DM_26)
 /// - Conçu pour représenter l'état réseau du joueur
 /// - Coordonnées et angles en Vec3i (quantification réseau)
@@ -45,64 +94,95 @@ struct PlayerState {
     // ---- Champs additionnels (extensibilité mod) ----
     std::unordered_map<std::string, int64_t> extras; ///< Champs supplémentaires éventuels
 
-    // ---- Helpers Netfields ----
-    std::optional<int64_t> getByNetfieldName(const std::string& name) const {
-        if (name == "commandTime") return commandTime;
-        if (name == "pm_type") return pm_type;
-        if (name == "weapon") return weapon;
-        if (name == "groundEntityNum") return groundEntityNum;
-        if (name == "legsAnim") return legsAnim;
-        if (name == "torsoAnim") return torsoAnim;
-        if (name == "eFlags") return eFlags;
-        if (name == "externalEvent") return externalEvent;
-        if (name == "clientNum") return clientNum;
-        if (name == "ping") return ping;
-
-        if (name == "origin[0]") return origin.x;
-        if (name == "origin[1]") return origin.y;
-        if (name == "origin[2]") return origin.z;
-
-        if (name == "velocity[0]") return velocity.x;
-        if (name == "velocity[1]") return velocity.y;
-        if (name == "velocity[2]") return velocity.z;
-
-        if (name == "viewangles[0]") return viewangles.x;
-        if (name == "viewangles[1]") return viewangles.y;
-        if (name == "viewangles[2]") return viewangles.z;
-
-        auto it = extras.find(name);
+    /// Champs portés par ce delta (0 = état complet). Ignoré par operator==
+    /// et par la sérialisation JSON ; n’a de sens que sur un snapshot delta.
+    FieldMask dirty {0};
+
+    // ---- Comparaison champ par champ ----
+
+    /// Masque des champs (parmi `within`) qui diffèrent entre a et b
+    friend FieldMask diffFields(const PlayerState& a, const PlayerState& b,
+                                FieldMask within = allPlayerFields) {
+        FieldMask m = 0;
+#define JKA_X(f) \
+        if ((within & fieldBit(PlayerField::f)) && !(a.f == b.f)) m |= fieldBit(PlayerField::f);
+        JKA_PLAYERSTATE_FIELDS(JKA_X)
+#undef JKA_X
+        return m;
+    }
+
+    /// Copie dans dst les seuls champs de src sélectionnés par mask
+    friend void mergeFields(PlayerState& dst, const PlayerState& src, FieldMask mask) {
+#define JKA_X(f) \
+        if (mask & fieldBit(PlayerField::f)) dst.f = src.f;
+        JKA_PLAYERSTATE_FIELDS(JKA_X)
+#undef JKA_X
+    }
+
+    /// Variante "move" : les collections sélectionnées sont déplacées depuis src
+    friend void mergeFields(PlayerState& dst, PlayerState&& src, FieldMask mask) {
+#define JKA_X(f) \
+        if (mask & fieldBit(PlayerField::f)) dst.f = std::move(src.f);
+        JKA_PLAYERSTATE_FIELDS(JKA_X)
+#undef JKA_X
+    }
+
+    friend bool operator==(const PlayerState& a, const PlayerState& b) {
+        return diffFields(a, b) == 0;
+    }
+    friend bool operator!=(const PlayerState& a, const PlayerState& b) { return !(a == b); }
+
+    // ---- Accès par feuille / nom netfield ----
+
+    int32_t getLeaf(PlayerLeaf leaf) const noexcept {
+        switch (leaf) {
+#define JKA_X(id, name, member) case PlayerLeaf::id: return leafScalar(member);
+        JKA_PLAYERSTATE_LEAVES(JKA_X)
+#undef JKA_X
+        default: return 0;
+        }
+    }
+
+    void setLeaf(PlayerLeaf leaf, int64_t value) noexcept {
+        switch (leaf) {
+#define JKA_X(id, name, member) case PlayerLeaf::id: leafAssign(member, value); break;
+        JKA_PLAYERSTATE_LEAVES(JKA_X)
+#undef JKA_X
+        default: break;
+        }
+    }
+
+    /// Recherche O(1) par hachage parfait, puis dans extras.
+    /// Entiers 64 bits : les valeurs de extras ne passent pas par un double
+    std::optional<int64_t> getByNetfieldName(std::string_view name) const {
+        int leaf = playerLeafHash.find(name);
+        if (leaf >= 0) return getLeaf(static_cast<PlayerLeaf>(leaf));
+
+        auto it = extras.find(std::string(name));
         if (it != extras.end()) return it->second;
 
         return std::nullopt;
     }
 
-    bool setByNetfieldName(const std::string& name, int64_t value) {
-        if (name == "commandTime") { commandTime = static_cast<int32_t>(value); return true; }
-        if (name == "pm_type") { pm_type = static_cast<int32_t>(value); return true; }
-        if (name == "weapon") { weapon = static_cast<int32_t>(value); return true; }
-        if (name == "groundEntityNum") { groundEntityNum = static_cast<int32_t>(value); return true; }
-        if (name == "legsAnim") { legsAnim = static_cast<int32_t>(value); return true; }
-        if (name == "torsoAnim") { torsoAnim = static_cast<int32_t>(value); return true; }
-        if (name == "eFlags") { eFlags = static_cast<int32_t>(value); return true; }
-        if (name == "externalEvent") { externalEvent = static_cast<int32_t>(value); return true; }
-        if (name == "clientNum") { clientNum = static_cast<int32_t>(value); return true; }
-        if (name == "ping") { ping = static_cast<int32_t>(value); return true; }
-
-        if (name == "origin[0]") { origin.x = static_cast<int32_t>(value); return true; }
-        if (name == "origin[1]") { origin.y = static_cast<int32_t>(value); return true; }
-        if (name == "origin[2]") { origin.z = static_cast<int32_t>(value); return true; }
-
-        if (name == "velocity[0]") { velocity.x = static_cast<int32_t>(value); return true; }
-        if (name == "velocity[1]") { velocity.y = static_cast<int32_t>(value); return true; }
-        if (name == "velocity[2]") { velocity.z = static_cast<int32_t>(value); return true; }
-
-        if (name == "viewangles[0]") { viewangles.x = static_cast<int32_t>(value); return true; }
-        if (name == "viewangles[1]") { viewangles.y = static_cast<int32_t>(value); return true; }
-        if (name == "viewangles[2]") { viewangles.z = static_cast<int32_t>(value); return true; }
-
-        extras[name] = value;
+    /// Les noms inconnus sont rangés dans extras
+    bool setByNetfieldName(std::string_view name, int64_t value) {
+        int leaf = playerLeafHash.find(name);
+        if (leaf >= 0) {
+            setLeaf(static_cast<PlayerLeaf>(leaf), value);
+            return true;
+        }
+
+        extras[std::string(name)] = value;
         return true;
     }
+
+    /// Appelle f(PlayerLeaf, nom, valeur) pour chaque feuille scalaire, dans l’ordre
+    template <typename F>
+    void forEachLeaf(F&& f) const {
+#define JKA_X(id, name, member) f(PlayerLeaf::id, std::string_view(name), leafScalar(member));
+        JKA_PLAYERSTATE_LEAVES(JKA_X)
+#undef JKA_X
+    }
 };
 
 // ---- JSON (nlohmann) ----
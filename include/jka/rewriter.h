@@ -0,0 +1,61 @@
+#ifndef DEMO_REWRITER_H
+#define DEMO_REWRITER_H
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <jka/demo.h>
+
+DEMO_NAMESPACE_START
+
+/**
+ * @brief Applies string rewrite rules on configstrings and server commands.
+ *
+ * Only messages holding a gamestate or server commands are decoded (they are
+ * found by peeking), all others keep their source bytes and are block copied
+ * by Demo::save, which makes rewriting I/O bound.
+ *
+ * Configstring rules see gamestate configstrings and "cs" commands. Command
+ * rules see all other commands. Big configstrings (bcs0/1/2) are left as is.
+ */
+class DemoRewriter {
+public:
+    /// Rewrites configstring value in place, returns true if it changed it.
+    typedef std::function<bool(int index, std::string& value)> ConfigstringRule;
+
+    /// Rewrites server command in place, returns true if it changed it.
+    typedef std::function<bool(std::string& command)> CommandRule;
+
+    explicit DemoRewriter(Demo& demo);
+
+    void addConfigstringRule(ConfigstringRule rule);
+    void addCommandRule(CommandRule rule);
+
+    /// Adds rules which replace player names (CS_PLAYERS "n" key) by prefix and
+    /// a number, consistently in configstrings and chat, tchat, print and cp
+    /// commands, and IPv4 addresses by 0.0.0.0 everywhere. In commands names
+    /// are replaced as whole words, so a name which is also a common word
+    /// ("a", "hi") is replaced wherever that word stands alone.
+    void addAnonymizeRules(const std::string& prefix = "Player");
+
+    /// Applies rules, changed messages stay loaded until saved.
+    /// Throws DemoException if a message cannot be loaded.
+    /// @return number of changed messages
+    int run();
+
+    /// Applies rules and saves demo to given file.
+    bool write(std::string_view filename);
+
+private:
+    bool rewriteConfigstring(int index, std::string& value) const;
+    bool rewriteCommand(std::string& command) const;
+
+    Demo&                         demo;
+    std::vector<ConfigstringRule> configstringRules;
+    std::vector<CommandRule>      commandRules;
+};
+
+DEMO_NAMESPACE_END
+
+#endif // DEMO_REWRITER_H
@@ -0,0 +1,108 @@
+#ifndef ROSTER_TIMELINE_H
+#define ROSTER_TIMELINE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <jka/bg_defs.h>
+#include <jka/configstring_timeline.h>
+
+DEMO_NAMESPACE_START
+
+/// Why a roster entry starts.
+enum RosterChange {
+    ROSTER_CONNECT = 0, ///< slot was empty
+    ROSTER_RENAME,      ///< "n" changed
+    ROSTER_TEAM,        ///< "t" changed
+    ROSTER_INFO         ///< other keys changed (model, duel wins...)
+};
+
+/**
+ * @brief Interval during which a client slot kept the same player info.
+ *
+ * Interval is [start, end), end is -1 while the player is still there at
+ * demo end. Entries following each other without gap belong to the same
+ * connection.
+ */
+struct RosterEntry {
+    int              clientNum;
+    int              startTime;
+    int              endTime;
+    int              startMessage;
+    int              endMessage;
+    RosterChange     change;
+    std::string_view name;  ///< "n", with color codes
+    int              team;  ///< "t" (team_t)
+    std::string_view model; ///< "model"
+    std::string_view info;  ///< whole CS_PLAYERS info string
+
+    bool contains(int serverTime) const {
+        return serverTime >= startTime && (endTime < 0 || serverTime < endTime);
+    }
+};
+
+/**
+ * @brief Who was in which client slot over a demo.
+ *
+ * Built from CS_PLAYERS configstring versions, either all at once from a
+ * ConfigstringTimeline or incrementally while decoding. Lookups by slot and
+ * time, and by name, are O(log n).
+ *
+ * Views point into info strings given to update(), which must outlive the
+ * roster (ConfigstringTimeline values do).
+ */
+class RosterTimeline {
+public:
+    RosterTimeline();
+
+    /// Rebuilds from player configstrings of timeline.
+    void build(const ConfigstringTimeline& timeline);
+
+    /// Records CS_PLAYERS + clientNum taking given value (empty on disconnect).
+    /// Changes of one slot must come in order.
+    void update(int clientNum, int messageId, int serverTime, std::string_view info);
+
+    /// Drops all entries.
+    void clear();
+
+    /// Entry of slot at server time, null if slot was empty.
+    /// Pointer is valid until next update.
+    const RosterEntry* at(int clientNum, int serverTime) const;
+    const RosterEntry* atMessage(int clientNum, int messageId) const;
+
+    /// Players in game at server time, indexed by clientNum (null for empty slots).
+    std::vector<const RosterEntry*> playersAt(int serverTime) const;
+
+    /// Entries whose name matches, ignoring color codes and case, in slot then
+    /// time order.
+    std::vector<RosterEntry> findByName(std::string_view name) const;
+
+    /// All entries of slot, oldest first.
+    const std::vector<RosterEntry>& getEntries(int clientNum) const { return slots[clientNum]; }
+
+    /// Number of entries over all slots.
+    int getEntriesCount() const;
+
+    /// Name without color codes, lower case: the key findByName compares.
+    static std::string cleanName(std::string_view name);
+
+private:
+    struct NameKey {
+        std::string key;
+        int         clientNum;
+        int         entry;
+
+        bool operator<(const NameKey& other) const;
+    };
+
+    void indexNames() const;
+
+    std::vector<std::vector<RosterEntry>> slots; //MAX_CLIENTS lists
+
+    mutable std::vector<NameKey> names; //sorted by key, rebuilt on demand
+    mutable bool                 namesDirty;
+};
+
+DEMO_NAMESPACE_END
+
+#endif // ROSTER_TIMELINE_H
@@ -1,4 +1,5 @@
 #pragma once
+#include <utility>
 #include "snapshot.hpp"
 
 namespace jka {
@@ -17,19 +18,36 @@ inline void makeInit(Snapshot& snap) {
 /**
  * Supprime les champs identiques par rapport à une référence.
  * Utile pour stocker/émettre un delta compact.
+ *
+ * Les états conservés portent ensuite dans `dirty` le masque des champs
+ * réellement modifiés. Si un état porte déjà un masque (delta issu du
+ * parsing), seuls ces champs sont comparés.
  */
 inline void removeNotChanged(Snapshot& target, const Snapshot& reference) {
-    if (target.playerState == reference.playerState) {
+    const auto psWithin = target.playerState.dirty ? target.playerState.dirty : allPlayerFields;
+    target.playerState.dirty = diffFields(target.playerState, reference.playerState, psWithin);
+    if (!target.playerState.dirty) {
         target.playerState = PlayerState{}; // reset si identique
     }
-    if (target.vehicleState == reference.vehicleState) {
+
+    const auto vsWithin = target.vehicleState.dirty ? target.vehicleState.dirty : allPlayerFields;
+    target.vehicleState.dirty = diffFields(target.vehicleState, reference.vehicleState, vsWithin);
+    if (!target.vehicleState.dirty) {
         target.vehicleState = PlayerState{};
     }
 
     // Parcours des entités
     for (auto it = target.entities.begin(); it != target.entities.end(); ) {
         auto jt = reference.entities.find(it->first);
-        if (jt != reference.entities.end() && jt->second == it->second) {
+        if (jt == reference.entities.end()) {
+            it->second.dirty = 0; // nouvelle entité : état complet
+            ++it;
+            continue;
+        }
+
+        const auto within = it->second.dirty ? it->second.dirty : allEntityFields;
+        it->second.dirty = diffFields(it->second, jt->second, within);
+        if (!it->second.dirty) {
             it = target.entities.erase(it); // supprime si identique
         } else {
             ++it;
@@ -37,28 +55,77 @@ inline void removeNotChanged(Snapshot& target, const Snapshot& reference) {
     }
 }
 
+namespace detail {
+
+// Fusionne un état delta dans l’accumulateur : champs "dirty" seulement si
+// le delta en porte, sinon remplacement complet (sauf état vide = inchangé).
+template <class State, class Delta>
+inline void mergeState(State& acc, Delta&& delta) {
+    if (delta.dirty) {
+        const auto mask = delta.dirty;
+        mergeFields(acc, std::forward<Delta>(delta), mask);
+    } else if (!(delta == State{})) {
+        acc = std::forward<Delta>(delta);
+    }
+    acc.dirty = 0;
+}
+
+template <class Entities, class Delta>
+inline void mergeEntity(Entities& acc, int id, Delta&& es) {
+    auto it = acc.find(id);
+    if (it != acc.end() && es.dirty) {
+        mergeFields(it->second, es, es.dirty);
+        it->second.dirty = 0;
+    } else {
+        auto& slot = acc.insert_or_assign(id, std::forward<Delta>(es)).first->second;
+        slot.dirty = 0;
+    }
+}
+
+} // namespace detail
+
 /**
- * Applique un delta sur un snapshot de base pour reconstruire un snapshot complet.
+ * Applique un delta directement sur l’accumulateur `acc` (état complet),
+ * sans recopier ses entités. Seuls les champs marqués `dirty` dans le delta
+ * sont recopiés ; un état sans masque remplace l’état existant.
+ *
+ * Les masques `dirty` de l’accumulateur sont remis à zéro au fil de la fusion.
  */
-inline Snapshot applyDelta(const Snapshot& base, const Snapshot& delta) {
-    Snapshot out = base;
+inline void applyDeltaInPlace(Snapshot& acc, const Snapshot& delta) {
+    acc.serverTime = delta.serverTime;
+    acc.deltaNum   = delta.deltaNum;
+    acc.flags      = delta.flags;
 
-    out.serverTime = delta.serverTime;
-    out.deltaNum   = delta.deltaNum;
-    out.flags      = delta.flags;
+    detail::mergeState(acc.playerState, delta.playerState);
+    detail::mergeState(acc.vehicleState, delta.vehicleState);
 
-    if (!(delta.playerState == PlayerState{})) {
-        out.playerState = delta.playerState;
-    }
-    if (!(delta.vehicleState == PlayerState{})) {
-        out.vehicleState = delta.vehicleState;
+    for (const auto& [id, es] : delta.entities) {
+        detail::mergeEntity(acc.entities, id, es);
     }
+}
 
-    // Fusion entités
-    for (const auto& [id, es] : delta.entities) {
-        out.entities[id] = es;
+/// Variante "move" : le delta est consommé (entités et collections déplacées).
+inline void applyDeltaInPlace(Snapshot& acc, Snapshot&& delta) {
+    acc.serverTime = delta.serverTime;
+    acc.deltaNum   = delta.deltaNum;
+    acc.flags      = delta.flags;
+
+    detail::mergeState(acc.playerState, std::move(delta.playerState));
+    detail::mergeState(acc.vehicleState, std::move(delta.vehicleState));
+
+    for (auto& [id, es] : delta.entities) {
+        detail::mergeEntity(acc.entities, id, std::move(es));
     }
+    delta.entities.clear();
+}
 
+/**
+ * Applique un delta sur un snapshot de base pour reconstruire un snapshot complet.
+ * (Copie `base` ; préférer applyDeltaInPlace dans les boucles par frame.)
+ */
+inline Snapshot applyDelta(const Snapshot& base, const Snapshot& delta) {
+    Snapshot out = base;
+    applyDeltaInPlace(out, delta);
     return out;
 }
 
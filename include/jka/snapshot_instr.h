@@ -57,12 +57,19 @@ public:
     const jka::PlayerState* getPlayerState() const noexcept { return &snapshot->playerState; }
     const jka::PlayerState* getVehicleState()const noexcept { return &snapshot->vehicleState; }
 
-    auto&       getEntities()       noexcept { return snapshot->entities; }
+    // Accès modifiable : l’instruction est considérée modifiée
+    auto&       getEntities()       noexcept { modified = true; return snapshot->entities; }
     const auto& getEntities() const noexcept { return snapshot->entities; }
 
-    // Delta application
-    void applyOn(const SnapshotInstr& base) {
-        *snapshot = jka::applyDelta(*base.snapshot, *snapshot);
+    // Application du delta sur l’accumulateur de l’appelant (état complet de
+    // la frame précédente), sans copie de la base. La variante rvalue
+    // consomme le delta.
+    void applyOn(jka::Snapshot& acc) const & {
+        jka::applyDeltaInPlace(acc, *snapshot);
+    }
+    void applyOn(jka::Snapshot& acc) && {
+        jka::applyDeltaInPlace(acc, std::move(*snapshot));
+        modified = true;
     }
     void removeNotChanged(const SnapshotInstr& ref) {
         jka::removeNotChanged(*snapshot, *ref.snapshot);
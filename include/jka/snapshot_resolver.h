@@ -0,0 +1,45 @@
+#ifndef SNAPSHOT_RESOLVER_H
+#define SNAPSHOT_RESOLVER_H
+
+#include <memory>
+#include <jka/defs.h>
+#include <jka/message.h>
+
+DEMO_NAMESPACE_START
+
+/**
+ * @brief Rebuilds full snapshots from delta compressed ones.
+ *
+ * Keeps the resolved snapshots of the last PACKET_BACKUP sequence numbers,
+ * which is as far back as a delta can refer. Messages must be fed in order.
+ */
+class SnapshotResolver {
+public:
+    SnapshotResolver();
+
+    /// Forgets all frames (new gamestate, seek).
+    void reset();
+
+    /// Feeds a message: resets on gamestate and resolves its snapshot.
+    /// @return full snapshot of the message, null if it has none or its base is missing
+    std::shared_ptr<Snapshot> update(Message* message);
+
+    /// Resolves one snapshot received in message with given sequence number.
+    std::shared_ptr<Snapshot> resolve(int sequenceNumber, Snapshot* snapshot);
+
+    /// Full snapshot of given sequence number, null if not in window.
+    std::shared_ptr<Snapshot> find(int sequenceNumber) const;
+
+    /// Stores delta compressed snapshots of message uncompressed (deltaNum 0),
+    /// resolved against frames in window. Message is not fed to the resolver.
+    /// @return false if a delta base is not in window
+    bool uncompress(Message* message) const;
+
+private:
+    std::shared_ptr<Snapshot> frames[PACKET_BACKUP];
+    int                       frameSequence[PACKET_BACKUP];
+};
+
+DEMO_NAMESPACE_END
+
+#endif // SNAPSHOT_RESOLVER_H
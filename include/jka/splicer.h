@@ -0,0 +1,56 @@
+#ifndef DEMO_SPLICER_H
+#define DEMO_SPLICER_H
+
+#include <ostream>
+#include <string_view>
+#include <vector>
+#include <jka/demo.h>
+
+DEMO_NAMESPACE_START
+
+/**
+ * @brief Builds one playable demo from message ranges of one or several demos.
+ *
+ * Ranges are written in order and renumbered, so that sequence numbers and
+ * server command numbers keep increasing. Where a range does not continue
+ * the previous one:
+ * - inside the same gamestate of the same demo (messages removed), the
+ *   configstrings changed in the skipped part are sent as cs commands
+ * - otherwise (other demo, other map, going back), the gamestate in effect
+ *   at range start is written first, with configstring changes folded in
+ *
+ * Snapshots delta compressed against a message left out are stored
+ * uncompressed. Other messages are copied without decoding, unless their
+ * server command numbers have to change.
+ *
+ * To remove messages [a, b) of a demo: addRange(demo, 0, a), addRange(demo, b).
+ */
+class DemoSplicer {
+public:
+    /// Appends messages [first, last) of demo (last < 0 means demo end).
+    /// Demo is not owned and must stay open until write().
+    void addRange(const Demo& demo, int first = 0, int last = -1);
+
+    /// Forgets all ranges.
+    void clear() { ranges.clear(); }
+
+    int getRangeCount() const { return (int)ranges.size(); }
+
+    /// Writes all ranges as one demo.
+    /// @return false if a range has no gamestate before it or a message cannot be read
+    bool write(std::string_view filename) const;
+    bool write(std::ostream& os) const;
+
+private:
+    struct Range {
+        const Demo* demo;
+        int         first;
+        int         last;
+    };
+
+    std::vector<Range> ranges;
+};
+
+DEMO_NAMESPACE_END
+
+#endif // DEMO_SPLICER_H
@@ -22,6 +22,7 @@ union Attribute {
 using Atribute = Attribute;
 
 class MessageBuffer;
+struct Field;
 
 enum DataType : int {
     INTEGER = 0,
@@ -63,6 +64,7 @@ protected:
 protected:
     int type;
     AttributeMap attributes;
+    bool modified = false;
 
 public:
     explicit State(int type) : type(type) {}
@@ -112,12 +114,20 @@ public:
     bool isAttributeSet(int id) const noexcept;
     bool isAtributeSet(int id) const noexcept { return isAttributeSet(id); } // Legacy
 
+    //netfield table describing attributes of this state type
+    const Field* getNetfields(int& count) const noexcept;
+
     //means that user changed something in objects
     virtual bool isChanged() const = 0;
 
     //means that nothing is happening in this message
     virtual bool noChanged() const = 0;
 
+    //means that content differs from what was loaded, set by every
+    //modifying method (Demo::save re-encodes only modified messages)
+    bool isModified() const noexcept { return modified; }
+    void setModified(bool value) noexcept { modified = value; }
+
     //removes all 0 in states
     virtual void removeNull() {}
 
@@ -153,7 +163,7 @@ public:
     bool isAttributeInteger(int id) const override;
 
     //set methods
-    void setRemove(bool remove) noexcept { toRemove = remove; }
+    void setRemove(bool remove) noexcept { toRemove = remove; modified = true; }
 
     //other const methods
     bool isRemoved() const noexcept { return toRemove; }
@@ -232,10 +242,10 @@ public:
     const StatsArray& getPowerups() const noexcept { return powerups; }
 
     // Setters for individual stats
-    void setStat(int id, int value) { stats[id] = value; }
-    void setPersistant(int id, int value) { persistant[id] = value; }
-    void setAmmo(int id, int value) { ammo[id] = value; }
-    void setPowerup(int id, int value) { powerups[id] = value; }
+    void setStat(int id, int value) { stats[id] = value; modified = true; }
+    void setPersistant(int id, int value) { persistant[id] = value; modified = true; }
+    void setAmmo(int id, int value) { ammo[id] = value; modified = true; }
+    void setPowerup(int id, int value) { powerups[id] = value; modified = true; }
 
     // Getters for individual stats with bounds checking
     int getStat(int id) const;
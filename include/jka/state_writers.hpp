@@ -0,0 +1,141 @@
+#pragma once
+// jka/state_writers.hpp — Sérialiseurs générés depuis JKA_ENTITYSTATE_LEAVES /
+// JKA_PLAYERSTATE_LEAVES : JSON en flux, CSV et colonnes .jkcol.
+// Aucun DOM intermédiaire : chaque feuille est écrite directement.
+
+#include <charconv>
+#include <string>
+#include <type_traits>
+
+#include "jka/columns.h"
+#include "jka/entitystate.hpp"
+#include "jka/json_writer.h"
+#include "jka/playerstate.hpp"
+
+namespace jka {
+
+namespace detail {
+
+inline void appendCsvValue(std::string& out, int v) {
+    char text[16];
+    auto result = std::to_chars(text, text + sizeof(text), v);
+    out.append(text, result.ptr - text);
+}
+
+inline void appendCsvValue(std::string& out, float v) {
+    char text[32];
+    auto result = std::to_chars(text, text + sizeof(text), v);
+    out.append(text, result.ptr - text);
+}
+
+template <typename Names>
+void appendCsvHeader(std::string& out, const Names& names) {
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        if (i) out += ',';
+        out += names[i];
+    }
+    out += '\n';
+}
+
+template <typename State>
+void appendCsvLeaves(std::string& out, const State& s) {
+    bool first = true;
+    s.forEachLeaf([&](auto, std::string_view, auto v) {
+        if (!first) out += ',';
+        first = false;
+        appendCsvValue(out, v);
+    });
+    out += '\n';
+}
+
+/// Une colonne par feuille : floats bruts (mappables), entiers en varint
+template <typename State>
+int addLeafColumns(DemoJKA::ColumnWriter& table, const State& prototype) {
+    int first = table.getColumnsCount();
+    prototype.forEachLeaf([&](auto, std::string_view name, auto v) {
+        if constexpr (std::is_same_v<decltype(v), float>)
+            table.addColumn(std::string(name), DemoJKA::COLUMN_FLOAT, DemoJKA::ENCODING_RAW);
+        else
+            table.addColumn(std::string(name), DemoJKA::COLUMN_INT, DemoJKA::ENCODING_VARINT);
+    });
+    return first;
+}
+
+template <typename State>
+void appendLeafColumns(DemoJKA::ColumnWriter& table, int first, const State& s) {
+    int column = first;
+    s.forEachLeaf([&](auto, std::string_view, auto v) {
+        if constexpr (std::is_same_v<decltype(v), float>)
+            table.appendFloat(column++, v);
+        else
+            table.appendInt(column++, v);
+    });
+}
+
+inline void writeJsonArray(DemoJKA::JsonWriter& json, std::string_view name, const std::vector<int32_t>& values) {
+    json.key(name);
+    json.beginArray();
+    for (int32_t v : values) json.value(v);
+    json.endArray();
+}
+
+} // namespace detail
+
+// ---- EntityState -----------------------------------------------------------
+
+/// Objet plat {"number": .., "pos.trBase[0]": .., ...}
+inline void writeJson(DemoJKA::JsonWriter& json, const EntityState& s) {
+    json.beginObject();
+    s.forEachLeaf([&](EntityLeaf, std::string_view name, auto v) {
+        json.key(name);
+        json.value(v);
+    });
+    json.endObject();
+}
+
+inline void appendEntityCsvHeader(std::string& out) { detail::appendCsvHeader(out, entityLeafNames); }
+inline void appendCsv(std::string& out, const EntityState& s) { detail::appendCsvLeaves(out, s); }
+
+/// Ajoute les colonnes des feuilles, retourne l’index de la première
+inline int addEntityColumns(DemoJKA::ColumnWriter& table) { return detail::addLeafColumns(table, EntityState{}); }
+inline void appendColumns(DemoJKA::ColumnWriter& table, int first, const EntityState& s) {
+    detail::appendLeafColumns(table, first, s);
+}
+
+// ---- PlayerState -----------------------------------------------------------
+
+/// Feuilles à plat, puis collections en tableaux et extras en objet
+inline void writeJson(DemoJKA::JsonWriter& json, const PlayerState& ps) {
+    json.beginObject();
+    ps.forEachLeaf([&](PlayerLeaf, std::string_view name, auto v) {
+        json.key(name);
+        json.value(v);
+    });
+
+    detail::writeJsonArray(json, "stats", ps.stats);
+    detail::writeJsonArray(json, "persistant", ps.persistant);
+    detail::writeJsonArray(json, "ammo", ps.ammo);
+    detail::writeJsonArray(json, "powerups", ps.powerups);
+
+    if (!ps.extras.empty()) {
+        json.key("extras");
+        json.beginObject();
+        for (const auto& [name, value] : ps.extras) {
+            json.key(name);
+            json.value(static_cast<std::int64_t>(value));
+        }
+        json.endObject();
+    }
+    json.endObject();
+}
+
+/// CSV et colonnes : feuilles scalaires seulement
+inline void appendPlayerCsvHeader(std::string& out) { detail::appendCsvHeader(out, playerLeafNames); }
+inline void appendCsv(std::string& out, const PlayerState& ps) { detail::appendCsvLeaves(out, ps); }
+
+inline int addPlayerColumns(DemoJKA::ColumnWriter& table) { return detail::addLeafColumns(table, PlayerState{}); }
+inline void appendColumns(DemoJKA::ColumnWriter& table, int first, const PlayerState& ps) {
+    detail::appendLeafColumns(table, first, ps);
+}
+
+} // namespace jka
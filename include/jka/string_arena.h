@@ -0,0 +1,44 @@
+#ifndef STRING_ARENA_H
+#define STRING_ARENA_H
+
+#include <memory>
+#include <string_view>
+#include <vector>
+#include <jka/defs.h>
+
+DEMO_NAMESPACE_START
+
+/**
+ * @brief Append-only storage for strings handed out as std::string_view.
+ *
+ * Strings are copied once into large blocks which never move, so views stay
+ * valid until the arena is cleared or destroyed.
+ */
+class StringArena {
+public:
+    StringArena() : current(0), used(0), total(0) {}
+
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+
+    /// Copies string into arena.
+    std::string_view store(std::string_view s);
+
+    /// Drops all strings, keeps current block for reuse.
+    void clear();
+
+    /// Bytes held by stored strings.
+    size_t size() const { return total; }
+
+private:
+    static const size_t BLOCK_SIZE = 1 << 14;
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char*                                current; //block short strings go to
+    size_t                               used;    //bytes used in current block
+    size_t                               total;
+};
+
+DEMO_NAMESPACE_END
+
+#endif // STRING_ARENA_H
@@ -0,0 +1,173 @@
+#include <jka/client_tracks.h>
+#include <jka/demo_block.h>
+
+DEMO_NAMESPACE_START
+
+namespace {
+
+//tracked fields, in DeltaResolver order
+enum EntityField {
+    E_TYPE = 0,
+    E_ORIGIN,           //3 fields
+    E_VELOCITY = E_ORIGIN + 3,
+    E_ANGLES = E_VELOCITY + 3,
+    E_WEAPON = E_ANGLES + 3,
+    E_LEGS_ANIM,
+    E_TORSO_ANIM
+};
+
+enum PlayerField {
+    P_CLIENTNUM = 0,
+    P_ORIGIN,
+    P_VELOCITY = P_ORIGIN + 3,
+    P_ANGLES = P_VELOCITY + 3,
+    P_WEAPON = P_ANGLES + 3,
+    P_LEGS_ANIM,
+    P_TORSO_ANIM,
+    P_HEALTH
+};
+
+const std::vector<std::string> ENTITY_FIELDS = {
+    "eType",
+    "pos.trBase[0]", "pos.trBase[1]", "pos.trBase[2]",
+    "pos.trDelta[0]", "pos.trDelta[1]", "pos.trDelta[2]",
+    "apos.trBase[0]", "apos.trBase[1]", "apos.trBase[2]",
+    "weapon", "legsAnim", "torsoAnim"
+};
+
+const std::vector<std::string> PLAYER_FIELDS = {
+    "clientNum",
+    "origin[0]", "origin[1]", "origin[2]",
+    "velocity[0]", "velocity[1]", "velocity[2]",
+    "viewangles[0]", "viewangles[1]", "viewangles[2]",
+    "weapon", "legsAnim", "torsoAnim",
+    "stats[0]" //STAT_HEALTH
+};
+
+static_assert(STAT_HEALTH == 0, "update health field name");
+
+}
+
+/*
+
+ClientTrack Implementation
+
+*/
+
+void ClientTrack::clear() {
+    time.clear();
+    originX.clear(); originY.clear(); originZ.clear();
+    velocityX.clear(); velocityY.clear(); velocityZ.clear();
+    pitch.clear(); yaw.clear(); roll.clear();
+    weapon.clear();
+    legsAnim.clear();
+    torsoAnim.clear();
+    health.clear();
+    fromPlayerState.clear();
+}
+
+void ClientTrack::reserve(size_t samples) {
+    time.reserve(samples);
+    originX.reserve(samples); originY.reserve(samples); originZ.reserve(samples);
+    velocityX.reserve(samples); velocityY.reserve(samples); velocityZ.reserve(samples);
+    pitch.reserve(samples); yaw.reserve(samples); roll.reserve(samples);
+    weapon.reserve(samples);
+    legsAnim.reserve(samples);
+    torsoAnim.reserve(samples);
+    health.reserve(samples);
+    fromPlayerState.reserve(samples);
+}
+
+/*
+
+ClientTracks Implementation
+
+*/
+
+ClientTracks::ClientTracks() : resolver(ENTITY_FIELDS, PLAYER_FIELDS), tracks(MAX_CLIENTS) {
+}
+
+void ClientTracks::clear() {
+    resolver.reset();
+
+    for (ClientTrack& track : tracks)
+        track.clear();
+}
+
+void ClientTracks::update(Message* message) {
+    const DeltaResolver::Frame* frame = resolver.update(message);
+    if (!frame)
+        return;
+
+    int recorder = resolver.getPlayer(*frame, P_CLIENTNUM);
+
+    //entities are sorted, players come first
+    for (int i = 0; i < frame->getEntitiesCount() && frame->entities[i] < MAX_CLIENTS; ++i) {
+        if (frame->entities[i] != recorder && resolver.get(*frame, i, E_TYPE) == ET_PLAYER)
+            addEntity(frame->entities[i], *frame, i);
+    }
+
+    addPlayer(*frame);
+}
+
+bool ClientTracks::build(const Demo& demo) {
+    clear();
+
+    DemoBlock block;
+
+    for (int i = 0; i < demo.getMessageCount(); ++i) {
+        Message msg;
+        if (!demo.readRawMessage(i, block) || !decodeDemoBlock(msg, block))
+            return false;
+
+        update(&msg);
+    }
+
+    return true;
+}
+
+void ClientTracks::addEntity(int clientNum, const DeltaResolver::Frame& frame, int i) {
+    ClientTrack& track = tracks[clientNum];
+
+    track.time.push_back(frame.serverTime);
+    track.originX.push_back(resolver.getFloat(frame, i, E_ORIGIN));
+    track.originY.push_back(resolver.getFloat(frame, i, E_ORIGIN + 1));
+    track.originZ.push_back(resolver.getFloat(frame, i, E_ORIGIN + 2));
+    track.velocityX.push_back(resolver.getFloat(frame, i, E_VELOCITY));
+    track.velocityY.push_back(resolver.getFloat(frame, i, E_VELOCITY + 1));
+    track.velocityZ.push_back(resolver.getFloat(frame, i, E_VELOCITY + 2));
+    track.pitch.push_back(resolver.getFloat(frame, i, E_ANGLES));
+    track.yaw.push_back(resolver.getFloat(frame, i, E_ANGLES + 1));
+    track.roll.push_back(resolver.getFloat(frame, i, E_ANGLES + 2));
+    track.weapon.push_back(resolver.get(frame, i, E_WEAPON));
+    track.legsAnim.push_back(resolver.get(frame, i, E_LEGS_ANIM));
+    track.torsoAnim.push_back(resolver.get(frame, i, E_TORSO_ANIM));
+    track.health.push_back(-1);
+    track.fromPlayerState.push_back(0);
+}
+
+void ClientTracks::addPlayer(const DeltaResolver::Frame& frame) {
+    int clientNum = resolver.getPlayer(frame, P_CLIENTNUM);
+    if (clientNum < 0 || clientNum >= MAX_CLIENTS)
+        return;
+
+    ClientTrack& track = tracks[clientNum];
+
+    track.time.push_back(frame.serverTime);
+    track.originX.push_back(resolver.getPlayerFloat(frame, P_ORIGIN));
+    track.originY.push_back(resolver.getPlayerFloat(frame, P_ORIGIN + 1));
+    track.originZ.push_back(resolver.getPlayerFloat(frame, P_ORIGIN + 2));
+    track.velocityX.push_back(resolver.getPlayerFloat(frame, P_VELOCITY));
+    track.velocityY.push_back(resolver.getPlayerFloat(frame, P_VELOCITY + 1));
+    track.velocityZ.push_back(resolver.getPlayerFloat(frame, P_VELOCITY + 2));
+    track.pitch.push_back(resolver.getPlayerFloat(frame, P_ANGLES));
+    track.yaw.push_back(resolver.getPlayerFloat(frame, P_ANGLES + 1));
+    track.roll.push_back(resolver.getPlayerFloat(frame, P_ANGLES + 2));
+    track.weapon.push_back(resolver.getPlayer(frame, P_WEAPON));
+    track.legsAnim.push_back(resolver.getPlayer(frame, P_LEGS_ANIM));
+    track.torsoAnim.push_back(resolver.getPlayer(frame, P_TORSO_ANIM));
+    track.health.push_back(resolver.getPlayer(frame, P_HEALTH));
+    track.fromPlayerState.push_back(1);
+}
+
+DEMO_NAMESPACE_END
@@ -0,0 +1,202 @@
+#include <jka/column_exporter.h>
+#include <jka/delta_resolver.h>
+#include <jka/demo_block.h>
+#include <jka/event_extractor.h>
+#include <jka/state.h>
+
+DEMO_NAMESPACE_START
+
+namespace {
+
+const char* const PLAYER_ARRAYS[] = { "stats", "persistant", "ammo", "powerups" };
+const int PLAYER_ARRAY_SIZE = 16;
+
+/// Netfield names of table, with their types.
+void listFields(const Field* fields, int count, std::vector<std::string>& names, std::vector<bool>& floats) {
+    for (int i = 0; i < count; ++i) {
+        names.push_back(fields[i]._name);
+        floats.push_back(fields[i].type == FIELD_FLOAT);
+    }
+}
+
+/// Adds one column per field, returns index of first one.
+int addFieldColumns(ColumnWriter& table, const std::vector<std::string>& names, const std::vector<bool>& floats,
+                    ColumnEncoding intEncoding) {
+    int first = table.getColumnsCount();
+
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (floats[i])
+            table.addColumn(names[i], COLUMN_FLOAT, ENCODING_RAW);
+        else
+            table.addColumn(names[i], COLUMN_INT, intEncoding);
+    }
+
+    return first;
+}
+
+}
+
+ColumnExporter::ColumnExporter(const Demo& demo) : demo(demo), snapshots(0), entityRows(0) {
+}
+
+bool ColumnExporter::write(const std::string& prefix) {
+    snapshots = 0;
+    entityRows = 0;
+
+    std::vector<std::string> entityNames, playerNames;
+    std::vector<bool> entityFloats, playerFloats;
+
+    listFields(EntityNetfield, sizeof(EntityNetfield) / sizeof(Field), entityNames, entityFloats);
+    listFields(PlayerNetfield, sizeof(PlayerNetfield) / sizeof(Field), playerNames, playerFloats);
+
+    for (const char* array : PLAYER_ARRAYS) {
+        for (int i = 0; i < PLAYER_ARRAY_SIZE; ++i) {
+            playerNames.push_back(std::string(array) + "[" + std::to_string(i) + "]");
+            playerFloats.push_back(false);
+        }
+    }
+
+    DeltaResolver resolver(entityNames, playerNames);
+
+    //snapshots
+    ColumnWriter snapshotTable;
+    int sMessage = snapshotTable.addColumn("message", COLUMN_INT);
+    int sSequence = snapshotTable.addColumn("sequence", COLUMN_INT);
+    int sTime = snapshotTable.addColumn("serverTime", COLUMN_INT);
+    int sDelta = snapshotTable.addColumn("deltaNum", COLUMN_INT, ENCODING_VARINT);
+    int sFlags = snapshotTable.addColumn("snapFlags", COLUMN_INT, ENCODING_VARINT);
+    int sEntities = snapshotTable.addColumn("entities", COLUMN_INT);
+
+    //player
+    ColumnWriter playerTable;
+    int pMessage = playerTable.addColumn("message", COLUMN_INT);
+    int pTime = playerTable.addColumn("serverTime", COLUMN_INT);
+    int pFields = addFieldColumns(playerTable, playerNames, playerFloats, ENCODING_DELTA_VARINT);
+
+    //entities, rows of different entities follow each other: no delta on fields
+    ColumnWriter entityTable;
+    int eMessage = entityTable.addColumn("message", COLUMN_INT);
+    int eTime = entityTable.addColumn("serverTime", COLUMN_INT);
+    int eNumber = entityTable.addColumn("number", COLUMN_INT);
+    int eFields = addFieldColumns(entityTable, entityNames, entityFloats, ENCODING_VARINT);
+
+    //commands
+    ColumnWriter commandTable;
+    int cMessage = commandTable.addColumn("message", COLUMN_INT);
+    int cTime = commandTable.addColumn("serverTime", COLUMN_INT);
+    int cSequence = commandTable.addColumn("sequence", COLUMN_INT);
+    int cText = commandTable.addColumn("text", COLUMN_STRING, ENCODING_RAW);
+
+    //events
+    ColumnWriter eventTable;
+    int vMessage = eventTable.addColumn("message", COLUMN_INT);
+    int vTime = eventTable.addColumn("serverTime", COLUMN_INT);
+    int vEntity = eventTable.addColumn("entityNum", COLUMN_INT, ENCODING_VARINT);
+    int vEvent = eventTable.addColumn("event", COLUMN_INT, ENCODING_VARINT);
+    int vParm = eventTable.addColumn("eventParm", COLUMN_INT, ENCODING_VARINT);
+    int vOther = eventTable.addColumn("otherEntityNum", COLUMN_INT, ENCODING_VARINT);
+    int vOther2 = eventTable.addColumn("otherEntityNum2", COLUMN_INT, ENCODING_VARINT);
+    int vTemp = eventTable.addColumn("temp", COLUMN_INT, ENCODING_VARINT);
+    int vPlayer = eventTable.addColumn("playerState", COLUMN_INT, ENCODING_VARINT);
+
+    EventExtractor events([&](const GameEvent& event) {
+        eventTable.appendInt(vMessage, event.messageId);
+        eventTable.appendInt(vTime, event.serverTime);
+        eventTable.appendInt(vEntity, event.entityNum);
+        eventTable.appendInt(vEvent, event.event);
+        eventTable.appendInt(vParm, event.eventParm);
+        eventTable.appendInt(vOther, event.otherEntityNum);
+        eventTable.appendInt(vOther2, event.otherEntityNum2);
+        eventTable.appendInt(vTemp, event.temp);
+        eventTable.appendInt(vPlayer, event.playerState);
+    });
+
+    DemoBlock block;
+    int commandSequence = -1;
+    int time = -1;
+
+    for (int i = 0; i < demo.getMessageCount(); ++i) {
+        Message msg;
+        if (!demo.readRawMessage(i, block) || !decodeDemoBlock(msg, block))
+            return false;
+
+        //commands come before the snapshot but are stamped with its time
+        bool hasSnapshot = false;
+        for (int j = 0; j < msg.getInstructionsCount(); ++j) {
+            if (Snapshot* snapshot = msg.getInstruction(j)->getSnapshot()) {
+                time = snapshot->getServertime();
+                hasSnapshot = true;
+            }
+        }
+
+        for (int j = 0; j < msg.getInstructionsCount(); ++j) {
+            Instruction* instr = msg.getInstruction(j);
+
+            if (Gamestate* gamestate = instr->getGamestate()) {
+                commandSequence = gamestate->getCommandSequence();
+            }
+            else if (ServerCommand* command = instr->getServerCommand()) {
+                if (command->getSequenceNumber() <= commandSequence)
+                    continue; //resent
+
+                commandSequence = command->getSequenceNumber();
+                commandTable.appendInt(cMessage, i);
+                commandTable.appendInt(cTime, time);
+                commandTable.appendInt(cSequence, commandSequence);
+                commandTable.appendString(cText, command->getCommand());
+            }
+            else if (Snapshot* snapshot = instr->getSnapshot()) {
+                snapshotTable.appendInt(sMessage, i);
+                snapshotTable.appendInt(sSequence, msg.getSeqNumber());
+                snapshotTable.appendInt(sTime, snapshot->getServertime());
+                snapshotTable.appendInt(sDelta, snapshot->getDeltanum());
+                snapshotTable.appendInt(sFlags, snapshot->getSnapflags());
+            }
+        }
+
+        events.update(i, &msg);
+
+        const DeltaResolver::Frame* frame = resolver.update(&msg);
+        if (!hasSnapshot)
+            continue;
+
+        snapshotTable.appendInt(sEntities, frame ? frame->getEntitiesCount() : -1);
+        ++snapshots;
+
+        if (!frame)
+            continue; //delta base missing
+
+        playerTable.appendInt(pMessage, i);
+        playerTable.appendInt(pTime, frame->serverTime);
+
+        for (int k = 0; k < resolver.getPlayerFieldsCount(); ++k) {
+            if (playerFloats[k])
+                playerTable.appendFloat(pFields + k, resolver.getPlayerFloat(*frame, k));
+            else
+                playerTable.appendInt(pFields + k, resolver.getPlayer(*frame, k));
+        }
+
+        for (int e = 0; e < frame->getEntitiesCount(); ++e) {
+            entityTable.appendInt(eMessage, i);
+            entityTable.appendInt(eTime, frame->serverTime);
+            entityTable.appendInt(eNumber, frame->entities[e]);
+
+            for (int k = 0; k < resolver.getEntityFieldsCount(); ++k) {
+                if (entityFloats[k])
+                    entityTable.appendFloat(eFields + k, resolver.getFloat(*frame, e, k));
+                else
+                    entityTable.appendInt(eFields + k, resolver.get(*frame, e, k));
+            }
+
+            ++entityRows;
+        }
+    }
+
+    return snapshotTable.write(prefix + ".snapshots.jkcol")
+        && playerTable.write(prefix + ".player.jkcol")
+        && entityTable.write(prefix + ".entities.jkcol")
+        && commandTable.write(prefix + ".commands.jkcol")
+        && eventTable.write(prefix + ".events.jkcol");
+}
+
+DEMO_NAMESPACE_END
@@ -0,0 +1,348 @@
+#include <jka/columns.h>
+
+#include <cstring>
+#include <fstream>
+
+DEMO_NAMESPACE_START
+
+namespace {
+
+const char FILE_MAGIC[8] = { 'J', 'K', 'C', 'O', 'L', '1', 0, 0 };
+const char END_MAGIC[4] = { 'J', 'K', 'C', '1' };
+const size_t ALIGNMENT = 8;
+
+bool isLittleEndian() {
+    const uint32_t one = 1;
+    return *(const byte*)&one == 1;
+}
+
+uint32_t zigzag(int value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+int unzigzag(uint32_t value) {
+    return (int)(value >> 1) ^ -(int)(value & 1);
+}
+
+void putVarint(std::vector<byte>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((byte)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((byte)value);
+}
+
+void putFixed32(std::vector<byte>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i)
+        out.push_back((byte)(value >> (8 * i)));
+}
+
+/// Bounded reader over column or footer bytes.
+class Reader {
+public:
+    Reader(const byte* data, size_t size) : data(data), end(data + size) {}
+
+    bool atEnd() const { return data == end; }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (data == end)
+                throw DemoException("truncated column data");
+
+            byte b = *data++;
+            value |= (uint64_t)(b & 0x7f) << shift;
+
+            if (!(b & 0x80))
+                return value;
+        }
+
+        throw DemoException("corrupted column varint");
+    }
+
+    uint32_t fixed32() {
+        if (end - data < 4)
+            throw DemoException("truncated column data");
+
+        uint32_t value = data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+        data += 4;
+        return value;
+    }
+
+    std::string_view bytes(size_t count) {
+        if ((size_t)(end - data) < count)
+            throw DemoException("truncated column data");
+
+        std::string_view view((const char*)data, count);
+        data += count;
+        return view;
+    }
+
+private:
+    const byte* data;
+    const byte* end;
+};
+
+}
+
+/*
+
+ColumnWriter Implementation
+
+*/
+
+ColumnWriter::ColumnWriter() {
+}
+
+ColumnWriter::~ColumnWriter() {
+}
+
+int ColumnWriter::addColumn(const std::string& name, ColumnType type, ColumnEncoding encoding) {
+    if (type == COLUMN_STRING && encoding != ENCODING_RAW)
+        throw DemoException("string columns are raw encoded");
+    if (type == COLUMN_FLOAT && encoding == ENCODING_DELTA_VARINT)
+        throw DemoException("float columns cannot be delta encoded");
+
+    Column column;
+    column.info.name = name;
+    column.info.type = type;
+    column.info.encoding = encoding;
+    column.info.rows = 0;
+    column.info.offset = 0;
+    column.info.size = 0;
+    column.last = 0;
+
+    columns.push_back(std::move(column));
+    return (int)columns.size() - 1;
+}
+
+void ColumnWriter::appendBits(Column& column, int value) {
+    switch (column.info.encoding) {
+    case ENCODING_RAW:
+        putFixed32(column.data, (uint32_t)value);
+        break;
+    case ENCODING_VARINT:
+        putVarint(column.data, zigzag(value));
+        break;
+    case ENCODING_DELTA_VARINT:
+        putVarint(column.data, zigzag((int)((uint32_t)value - (uint32_t)column.last)));
+        column.last = value;
+        break;
+    }
+
+    ++column.info.rows;
+}
+
+void ColumnWriter::appendInt(int column, int value) {
+    assert(columns[column].info.type == COLUMN_INT);
+    appendBits(columns[column], value);
+}
+
+void ColumnWriter::appendFloat(int column, float value) {
+    assert(columns[column].info.type == COLUMN_FLOAT);
+
+    int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    appendBits(columns[column], bits);
+}
+
+void ColumnWriter::appendString(int column, std::string_view value) {
+    Column& target = columns[column];
+    assert(target.info.type == COLUMN_STRING);
+
+    putVarint(target.data, value.size());
+    target.data.insert(target.data.end(), value.begin(), value.end());
+    ++target.info.rows;
+}
+
+bool ColumnWriter::write(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    static const char padding[ALIGNMENT] = {};
+    size_t position = sizeof(FILE_MAGIC);
+    std::vector<byte> footer;
+
+    file.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+
+    for (const Column& column : columns) {
+        size_t pad = (ALIGNMENT - position % ALIGNMENT) % ALIGNMENT;
+        file.write(padding, pad);
+        position += pad;
+
+        file.write((const char*)column.data.data(), column.data.size());
+
+        putVarint(footer, column.info.name.size());
+        footer.insert(footer.end(), column.info.name.begin(), column.info.name.end());
+        footer.push_back((byte)column.info.type);
+        footer.push_back((byte)column.info.encoding);
+        putVarint(footer, column.info.rows);
+        putVarint(footer, position);
+        putVarint(footer, column.data.size());
+
+        position += column.data.size();
+    }
+
+    putFixed32(footer, (uint32_t)footer.size());
+    footer.insert(footer.end(), END_MAGIC, END_MAGIC + sizeof(END_MAGIC));
+
+    file.write((const char*)footer.data(), footer.size());
+    return file.good();
+}
+
+void ColumnWriter::clear() {
+    columns.clear();
+}
+
+/*
+
+ColumnFile Implementation
+
+*/
+
+ColumnFile::ColumnFile() : data(0), length(0) {
+}
+
+ColumnFile::~ColumnFile() {
+}
+
+bool ColumnFile::open(const std::string& filename) {
+    columns.clear();
+    owned.clear();
+    data = 0;
+    length = 0;
+
+    source = openDemoSource(filename);
+    if (!source)
+        return false;
+
+    length = source->size();
+    data = source->view(0, length);
+
+    if (!data) { //not mapped, keep a copy
+        owned.resize(length);
+        if (!source->seek(0) || source->read(owned.data(), length) != length)
+            return false;
+        data = owned.data();
+    }
+
+    if (length < sizeof(FILE_MAGIC) + 8 || memcmp(data, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0
+        || memcmp(data + length - sizeof(END_MAGIC), END_MAGIC, sizeof(END_MAGIC)) != 0)
+        return false;
+
+    Reader sizeReader(data + length - 8, 4);
+    size_t footerSize = sizeReader.fixed32();
+    if (footerSize > length - sizeof(FILE_MAGIC) - 8)
+        return false;
+
+    try {
+        Reader footer(data + length - 8 - footerSize, footerSize);
+
+        while (!footer.atEnd()) {
+            ColumnInfo info;
+            info.name = std::string(footer.bytes(footer.varint()));
+            info.type = (ColumnType)(byte)footer.bytes(1)[0];
+            info.encoding = (ColumnEncoding)(byte)footer.bytes(1)[0];
+            info.rows = footer.varint();
+            info.offset = footer.varint();
+            info.size = footer.varint();
+
+            if (info.type > COLUMN_STRING || info.encoding > ENCODING_DELTA_VARINT
+                || info.offset > length || info.size > length - info.offset
+                || info.rows > info.size) //values take one byte at least
+                return false;
+
+            columns.push_back(std::move(info));
+        }
+    }
+    catch (DemoException&) {
+        columns.clear();
+        return false;
+    }
+
+    return true;
+}
+
+int ColumnFile::findColumn(std::string_view name) const {
+    for (size_t i = 0; i < columns.size(); ++i)
+        if (columns[i].name == name)
+            return (int)i;
+
+    return -1;
+}
+
+const byte* ColumnFile::columnData(const ColumnInfo& info) const {
+    return data + info.offset;
+}
+
+std::vector<int> ColumnFile::readInts(int column) const {
+    const ColumnInfo& info = columns[column];
+    if (info.type == COLUMN_STRING)
+        throw DemoException("column " + info.name + " holds strings");
+
+    std::vector<int> values(info.rows);
+    Reader reader(columnData(info), info.size);
+    int last = 0;
+
+    for (size_t i = 0; i < info.rows; ++i) {
+        switch (info.encoding) {
+        case ENCODING_RAW:
+            values[i] = (int)reader.fixed32();
+            break;
+        case ENCODING_VARINT:
+            values[i] = unzigzag((uint32_t)reader.varint());
+            break;
+        case ENCODING_DELTA_VARINT:
+            last = (int)((uint32_t)last + (uint32_t)unzigzag((uint32_t)reader.varint()));
+            values[i] = last;
+            break;
+        }
+    }
+
+    return values;
+}
+
+std::vector<float> ColumnFile::readFloats(int column) const {
+    const ColumnInfo& info = columns[column];
+    if (info.type != COLUMN_FLOAT)
+        throw DemoException("column " + info.name + " does not hold floats");
+
+    std::vector<float> values(info.rows);
+
+    if (const float* direct = floatData(column)) {
+        memcpy(values.data(), direct, info.rows * sizeof(float));
+        return values;
+    }
+
+    std::vector<int> bits = readInts(column);
+    memcpy(values.data(), bits.data(), info.rows * sizeof(float));
+    return values;
+}
+
+std::vector<std::string_view> ColumnFile::readStrings(int column) const {
+    const ColumnInfo& info = columns[column];
+    if (info.type != COLUMN_STRING)
+        throw DemoException("column " + info.name + " does not hold strings");
+
+    std::vector<std::string_view> values(info.rows);
+    Reader reader(columnData(info), info.size);
+
+    for (size_t i = 0; i < info.rows; ++i)
+        values[i] = reader.bytes(reader.varint());
+
+    return values;
+}
+
+const float* ColumnFile::floatData(int column) const {
+    const ColumnInfo& info = columns[column];
+
+    if (info.type != COLUMN_FLOAT || info.encoding != ENCODING_RAW || !isLittleEndian()
+        || info.size < info.rows * sizeof(float) || (uintptr_t)columnData(info) % alignof(float))
+        return 0;
+
+    return (const float*)columnData(info);
+}
+
+DEMO_NAMESPACE_END
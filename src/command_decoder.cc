@@ -0,0 +1,168 @@
+#include <jka/command_decoder.h>
+
+DEMO_NAMESPACE_START
+
+namespace {
+
+struct CommandName {
+    std::string_view  name;
+    ServerCommandType type;
+};
+
+const CommandName COMMAND_NAMES[] = {
+    { "cs", SCMD_CS },
+    { "bcs0", SCMD_BCS0 },
+    { "bcs1", SCMD_BCS1 },
+    { "bcs2", SCMD_BCS2 },
+    { "print", SCMD_PRINT },
+    { "cp", SCMD_CP },
+    { "chat", SCMD_CHAT },
+    { "tchat", SCMD_TCHAT },
+    { "scores", SCMD_SCORES },
+    { "tinfo", SCMD_TINFO },
+    { "map_restart", SCMD_MAP_RESTART },
+    { "disconnect", SCMD_DISCONNECT }
+};
+
+const char COLOR_ESCAPE = '^';
+const std::string_view SPEAKER_END = "\x19: "; //after name in G_Say
+
+bool isColorCode(std::string_view s, size_t i) {
+    return i + 1 < s.size() && s[i] == COLOR_ESCAPE && s[i + 1] != COLOR_ESCAPE;
+}
+
+/// Rows fully present in command, clamped to MAX_CLIENTS.
+int rowsCount(const CommandTokenizer& command, int declared, int first, int fields) {
+    int available = (command.argc() - first) / fields;
+    if (declared > available)
+        declared = available;
+    if (declared > MAX_CLIENTS)
+        declared = MAX_CLIENTS;
+    return declared < 0 ? 0 : declared;
+}
+
+}
+
+ServerCommandType getServerCommandType(std::string_view name) {
+    for (const CommandName& entry : COMMAND_NAMES)
+        if (entry.name == name)
+            return entry.type;
+
+    return SCMD_UNKNOWN;
+}
+
+bool decodeConfigstring(const CommandTokenizer& command, ConfigstringEvent& event) {
+    if (command.argc() < 3 || command.argv(0) != "cs")
+        return false;
+
+    event.index = command.argi(1);
+    event.value = command.argv(2);
+
+    return event.index >= 0 && event.index < MAX_CONFIGSTRINGS;
+}
+
+bool decodePrint(const CommandTokenizer& command, PrintEvent& event) {
+    ServerCommandType type = getServerCommandType(command.argv(0));
+    if (type != SCMD_PRINT && type != SCMD_CP)
+        return false;
+
+    event.center = (type == SCMD_CP);
+    event.text = command.argv(1);
+
+    return true;
+}
+
+bool decodeChat(const CommandTokenizer& command, ChatEvent& event) {
+    ServerCommandType type = getServerCommandType(command.argv(0));
+    if ((type != SCMD_CHAT && type != SCMD_TCHAT) || command.argc() < 2)
+        return false;
+
+    event.team = (type == SCMD_TCHAT);
+    event.clientNum = command.argc() > 2 ? command.argi(2) : -1;
+    event.text = command.argv(1);
+    event.speaker = std::string_view();
+    event.message = event.text;
+
+    size_t end = event.text.find(SPEAKER_END);
+    if (end == std::string_view::npos)
+        return true;
+
+    std::string_view speaker = event.text.substr(0, end);
+    event.message = event.text.substr(end + SPEAKER_END.size());
+
+    //team chat: "\x19(<name>^7\x19)\x19: "
+    if (event.team && !speaker.empty() && speaker[0] == '\x19')
+        speaker.remove_prefix(1);
+
+    if (event.team && !speaker.empty() && speaker[0] == '(') {
+        speaker.remove_prefix(1);
+        if (!speaker.empty() && speaker[speaker.size() - 1] == ')')
+            speaker.remove_suffix(1);
+        if (!speaker.empty() && speaker[speaker.size() - 1] == '\x19')
+            speaker.remove_suffix(1);
+    }
+
+    //color reset appended to name
+    if (speaker.size() >= 2 && isColorCode(speaker, speaker.size() - 2))
+        speaker.remove_suffix(2);
+
+    if (isColorCode(event.message, 0))
+        event.message.remove_prefix(2);
+
+    event.speaker = speaker;
+    return true;
+}
+
+bool decodeScores(const CommandTokenizer& command, ScoresEvent& event) {
+    if (command.argc() < 4 || command.argv(0) != "scores")
+        return false;
+
+    event.count = rowsCount(command, command.argi(1), 4, ScoresEvent::FIELDS);
+    event.redScore = command.argi(2);
+    event.blueScore = command.argi(3);
+
+    for (int i = 0; i < event.count; ++i) {
+        int arg = 4 + i * ScoresEvent::FIELDS;
+        ScoreEntry& entry = event.entries[i];
+
+        entry.client = command.argi(arg);
+        entry.score = command.argi(arg + 1);
+        entry.ping = command.argi(arg + 2);
+        entry.time = command.argi(arg + 3);
+        entry.scoreFlags = command.argi(arg + 4);
+        entry.powerups = command.argi(arg + 5);
+        entry.accuracy = command.argi(arg + 6);
+        entry.impressiveCount = command.argi(arg + 7);
+        entry.excellentCount = command.argi(arg + 8);
+        entry.gauntletCount = command.argi(arg + 9);
+        entry.defendCount = command.argi(arg + 10);
+        entry.assistCount = command.argi(arg + 11);
+        entry.perfect = command.argi(arg + 12);
+        entry.captures = command.argi(arg + 13);
+    }
+
+    return true;
+}
+
+bool decodeTeamInfo(const CommandTokenizer& command, TeamInfoEvent& event) {
+    if (command.argc() < 2 || command.argv(0) != "tinfo")
+        return false;
+
+    event.count = rowsCount(command, command.argi(1), 2, TeamInfoEvent::FIELDS);
+
+    for (int i = 0; i < event.count; ++i) {
+        int arg = 2 + i * TeamInfoEvent::FIELDS;
+        TeamInfoEntry& entry = event.entries[i];
+
+        entry.client = command.argi(arg);
+        entry.location = command.argi(arg + 1);
+        entry.health = command.argi(arg + 2);
+        entry.armor = command.argi(arg + 3);
+        entry.weapon = command.argi(arg + 4);
+        entry.powerups = command.argi(arg + 5);
+    }
+
+    return true;
+}
+
+DEMO_NAMESPACE_END
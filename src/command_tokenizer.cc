@@ -0,0 +1,97 @@
+#include <jka/command_tokenizer.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+
+DEMO_NAMESPACE_START
+
+int CommandTokenizer::tokenize(std::string_view line) {
+    text = line;
+    count = 0;
+
+    const char* p = line.data();
+    const char* end = p + line.size();
+
+    while (count < MAX_TOKENS) {
+        //skip whitespace and comments
+        for (;;) {
+            while (p < end && (unsigned char)*p <= ' ')
+                ++p;
+
+            if (p == end)
+                return count;
+
+            if (p[0] == '/' && p + 1 < end && p[1] == '/')
+                return count; //rest of line is a comment
+
+            if (p[0] == '/' && p + 1 < end && p[1] == '*') {
+                p += 2;
+                while (p < end && !(p[0] == '*' && p + 1 < end && p[1] == '/'))
+                    ++p;
+                if (p == end)
+                    return count;
+                p += 2;
+                continue;
+            }
+
+            break;
+        }
+
+        if (*p == '"') {
+            const char* start = ++p;
+            while (p < end && *p != '"')
+                ++p;
+
+            tokens[count++] = std::string_view(start, p - start);
+
+            if (p == end)
+                return count;
+            ++p;
+            continue;
+        }
+
+        const char* start = p;
+        while (p < end && (unsigned char)*p > ' ' && *p != '"') {
+            if (p[0] == '/' && p + 1 < end && (p[1] == '/' || p[1] == '*'))
+                break;
+            ++p;
+        }
+
+        tokens[count++] = std::string_view(start, p - start);
+    }
+
+    return count;
+}
+
+std::string_view CommandTokenizer::rest(int i) const {
+    if (i < 0 || i >= count)
+        return std::string_view();
+
+    //include opening quote of a quoted argument
+    size_t start = tokens[i].data() - text.data();
+    if (start > 0 && text[start - 1] == '"')
+        --start;
+
+    return text.substr(start);
+}
+
+int CommandTokenizer::toInt(std::string_view s) {
+    size_t i = 0;
+    while (i < s.size() && (s[i] == ' ' || (s[i] >= '\t' && s[i] <= '\r')))
+        ++i;
+
+    bool negative = false;
+    if (i < s.size() && (s[i] == '-' || s[i] == '+'))
+        negative = (s[i++] == '-');
+
+    //untrusted input: long digit runs saturate instead of overflowing
+    const int64_t limit = negative ? -(int64_t)INT_MIN : INT_MAX;
+    int64_t value = 0;
+    for (; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i)
+        value = std::min(limit, value * 10 + (s[i] - '0'));
+
+    return (int)(negative ? -value : value);
+}
+
+DEMO_NAMESPACE_END
@@ -0,0 +1,389 @@
+#include <jka/compressed_source.h>
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef JKA_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef JKA_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+DEMO_NAMESPACE_START
+
+namespace {
+
+const size_t INPUT_SIZE = 1 << 16;          //compressed bytes read at once
+const size_t CHUNK_SIZE = 1 << 16;          //decoded bytes per ring chunk
+const size_t RING_SIZE = 16;                //chunks kept for backward seeks
+const size_t CHECKPOINT_SPACING = 1 << 22;  //decoded bytes between checkpoints
+
+}
+
+class CompressedSourceImpl {
+public:
+    struct Checkpoint {
+        size_t in;  //raw offset where decoding resumes
+        size_t out; //decoded offset at that point
+#ifdef JKA_HAVE_ZLIB
+        std::shared_ptr<z_stream> state; //inflate state, null at stream start
+#endif
+
+        Checkpoint(size_t in = 0, size_t out = 0) : in(in), out(out) {}
+    };
+
+    struct Chunk {
+        size_t            start;
+        size_t            length;
+        std::vector<byte> data;
+
+        Chunk() : start(0), length(0) {}
+    };
+
+    CompressedSourceImpl(std::unique_ptr<DemoSource> raw, CompressedSource::Format format);
+    ~CompressedSourceImpl();
+
+    void restart(const Checkpoint& checkpoint);
+    size_t decode(byte* out, size_t length);
+    void decodeChunk(Chunk& chunk);
+    void addCheckpoint();
+    const Chunk* fetch(size_t offset);
+    bool reach(size_t offset);
+
+    std::unique_ptr<DemoSource> raw;
+    CompressedSource::Format    format;
+
+    size_t total;    //decoded size, known once indexed
+    size_t position; //read position in decoded data
+    size_t frontier; //furthest decoded offset so far
+    bool   indexed;  //end reached once, checkpoints are complete
+
+    std::vector<byte> input;
+    size_t            inputStart; //raw offset of input[0]
+    size_t            inputLength;
+    size_t            decoded;    //decoded offset of decoder output
+    bool              ended;
+    bool              frameEnd;   //decoder stopped between gzip members/zstd frames
+
+#ifdef JKA_HAVE_ZLIB
+    z_stream zs;
+    bool     zsInit;
+#endif
+#ifdef JKA_HAVE_ZSTD
+    ZSTD_DCtx*    zctx;
+    ZSTD_inBuffer zin;
+#endif
+
+    std::vector<Checkpoint> checkpoints;
+    std::vector<Chunk>      ring;
+    size_t                  ringNext;
+};
+
+CompressedSourceImpl::CompressedSourceImpl(std::unique_ptr<DemoSource> source, CompressedSource::Format format)
+    : raw(std::move(source)), format(format), total(0), position(0), frontier(0), indexed(false),
+    input(INPUT_SIZE), inputStart(0), inputLength(0), decoded(0), ended(false), frameEnd(true), ringNext(0) {
+
+#ifdef JKA_HAVE_ZLIB
+    zsInit = false;
+#endif
+#ifdef JKA_HAVE_ZSTD
+    zctx = 0;
+#endif
+
+    if (!CompressedSource::isSupported(format))
+        throw DemoException("compressed demo format not supported by this build");
+
+    //checkpoints are recorded by the first read going through the data
+    checkpoints.push_back(Checkpoint());
+    restart(checkpoints[0]);
+
+    ring.resize(RING_SIZE);
+}
+
+CompressedSourceImpl::~CompressedSourceImpl() {
+#ifdef JKA_HAVE_ZLIB
+    if (zsInit)
+        inflateEnd(&zs);
+#endif
+#ifdef JKA_HAVE_ZSTD
+    if (zctx)
+        ZSTD_freeDCtx(zctx);
+#endif
+}
+
+void CompressedSourceImpl::restart(const Checkpoint& checkpoint) {
+    raw->seek(checkpoint.in);
+    inputStart = checkpoint.in;
+    inputLength = 0;
+    decoded = checkpoint.out;
+    ended = false;
+    frameEnd = true;
+
+#ifdef JKA_HAVE_ZLIB
+    if (format == CompressedSource::FORMAT_GZIP) {
+        if (zsInit)
+            inflateEnd(&zs);
+
+        memset(&zs, 0, sizeof(zs));
+        int ret = checkpoint.state ? inflateCopy(&zs, checkpoint.state.get())
+                                   : inflateInit2(&zs, 15 + 32); //gzip header
+        if (ret != Z_OK)
+            throw DemoException("cannot initialize inflate");
+
+        zsInit = true;
+        zs.next_in = 0;
+        zs.avail_in = 0;
+    }
+#endif
+#ifdef JKA_HAVE_ZSTD
+    if (format == CompressedSource::FORMAT_ZSTD) {
+        if (!zctx)
+            zctx = ZSTD_createDCtx();
+        ZSTD_DCtx_reset(zctx, ZSTD_reset_session_only);
+
+        zin.src = input.data();
+        zin.size = 0;
+        zin.pos = 0;
+    }
+#endif
+}
+
+size_t CompressedSourceImpl::decode(byte* out, size_t length) {
+    (void)out; //unused when built without decompressors
+    size_t produced = 0;
+
+    while (produced < length && !ended) {
+        bool inputEmpty = true;
+#ifdef JKA_HAVE_ZLIB
+        if (format == CompressedSource::FORMAT_GZIP)
+            inputEmpty = (zs.avail_in == 0);
+#endif
+#ifdef JKA_HAVE_ZSTD
+        if (format == CompressedSource::FORMAT_ZSTD)
+            inputEmpty = (zin.pos == zin.size);
+#endif
+
+        if (inputEmpty) {
+            inputStart += inputLength;
+            inputLength = raw->read(input.data(), input.size());
+
+            if (!inputLength) { //end of compressed data
+                if (!frameEnd)
+                    throw DemoException("compressed demo is truncated");
+                ended = true;
+                break;
+            }
+
+#ifdef JKA_HAVE_ZLIB
+            zs.next_in = input.data();
+            zs.avail_in = (uInt)inputLength;
+#endif
+#ifdef JKA_HAVE_ZSTD
+            zin.src = input.data();
+            zin.size = inputLength;
+            zin.pos = 0;
+#endif
+        }
+
+#ifdef JKA_HAVE_ZLIB
+        if (format == CompressedSource::FORMAT_GZIP) {
+            zs.next_out = out + produced;
+            zs.avail_out = (uInt)(length - produced);
+
+            int ret = inflate(&zs, Z_NO_FLUSH);
+            produced = length - zs.avail_out;
+
+            if (ret == Z_STREAM_END) {
+                //concatenated gzip members continue
+                inflateReset(&zs);
+                frameEnd = true;
+            }
+            else if (ret == Z_OK || ret == Z_BUF_ERROR) {
+                frameEnd = false;
+            }
+            else {
+                throw DemoException("corrupted gzip demo");
+            }
+        }
+#endif
+#ifdef JKA_HAVE_ZSTD
+        if (format == CompressedSource::FORMAT_ZSTD) {
+            ZSTD_outBuffer zout = { out, length, produced };
+
+            size_t ret = ZSTD_decompressStream(zctx, &zout, &zin);
+            if (ZSTD_isError(ret))
+                throw DemoException("corrupted zstd demo");
+
+            produced = zout.pos;
+            frameEnd = (ret == 0);
+        }
+#endif
+    }
+
+    decoded += produced;
+    return produced;
+}
+
+void CompressedSourceImpl::addCheckpoint() {
+    if (decoded < checkpoints.back().out + CHECKPOINT_SPACING)
+        return;
+
+#ifdef JKA_HAVE_ZLIB
+    if (format == CompressedSource::FORMAT_GZIP) {
+        Checkpoint checkpoint(inputStart + (zs.next_in - input.data()), decoded);
+        checkpoint.state.reset(new z_stream(), [](z_stream* state) {
+            inflateEnd(state);
+            delete state;
+        });
+
+        if (inflateCopy(checkpoint.state.get(), &zs) != Z_OK)
+            return;
+
+        checkpoints.push_back(checkpoint);
+    }
+#endif
+#ifdef JKA_HAVE_ZSTD
+    if (format == CompressedSource::FORMAT_ZSTD && frameEnd)
+        checkpoints.push_back(Checkpoint(inputStart + zin.pos, decoded));
+#endif
+}
+
+void CompressedSourceImpl::decodeChunk(Chunk& chunk) {
+    chunk.data.resize(CHUNK_SIZE);
+    chunk.start = decoded;
+    chunk.length = 0;
+
+    while (chunk.length < CHUNK_SIZE && !ended) {
+        chunk.length += decode(chunk.data.data() + chunk.length, CHUNK_SIZE - chunk.length);
+        addCheckpoint();
+    }
+
+    frontier = std::max(frontier, decoded);
+    if (ended && !indexed) {
+        total = decoded;
+        indexed = true;
+    }
+}
+
+const CompressedSourceImpl::Chunk* CompressedSourceImpl::fetch(size_t offset) {
+    if (indexed && offset >= total)
+        return 0;
+
+    for (size_t i = 0; i < ring.size(); ++i)
+        if (ring[i].length && offset >= ring[i].start && offset < ring[i].start + ring[i].length)
+            return &ring[i];
+
+    //nearest checkpoint before offset, used when it saves work
+    size_t best = 0;
+    for (size_t i = 1; i < checkpoints.size() && checkpoints[i].out <= offset; ++i)
+        best = i;
+
+    if (offset < decoded || checkpoints[best].out > decoded)
+        restart(checkpoints[best]);
+
+    while (!ended) {
+        Chunk& chunk = ring[ringNext];
+        ringNext = (ringNext + 1) % ring.size();
+
+        decodeChunk(chunk);
+
+        if (offset >= chunk.start && offset < chunk.start + chunk.length)
+            return &chunk;
+    }
+
+    return 0;
+}
+
+//decodes forward until offset is known to be in data, extending the index
+bool CompressedSourceImpl::reach(size_t offset) {
+    if (!indexed && offset > frontier)
+        fetch(offset - 1);
+
+    return !indexed || offset <= total;
+}
+
+/*
+
+CompressedSource Implementation
+
+*/
+
+CompressedSource::Format CompressedSource::detect(DemoSource& raw) {
+    byte magic[4] = { 0, 0, 0, 0 };
+
+    raw.seek(0);
+    size_t got = raw.read(magic, sizeof(magic));
+    raw.seek(0);
+
+    //deflate method, reserved flag bits clear
+    if (got >= 4 && magic[0] == 0x1f && magic[1] == 0x8b && magic[2] == 0x08 && !(magic[3] & 0xe0))
+        return FORMAT_GZIP;
+
+    if (got >= 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd)
+        return FORMAT_ZSTD;
+
+    return FORMAT_NONE;
+}
+
+bool CompressedSource::isSupported(Format format) {
+    switch (format) {
+#ifdef JKA_HAVE_ZLIB
+    case FORMAT_GZIP:
+        return true;
+#endif
+#ifdef JKA_HAVE_ZSTD
+    case FORMAT_ZSTD:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+CompressedSource::CompressedSource(std::unique_ptr<DemoSource> raw, Format format)
+    : impl(new CompressedSourceImpl(std::move(raw), format)) {
+}
+
+CompressedSource::~CompressedSource() {
+}
+
+size_t CompressedSource::read(void* dest, size_t length) {
+    size_t got = 0;
+
+    while (got < length) {
+        const CompressedSourceImpl::Chunk* chunk = impl->fetch(impl->position);
+        if (!chunk)
+            break;
+
+        size_t skip = impl->position - chunk->start;
+        size_t count = std::min(length - got, chunk->length - skip);
+
+        memcpy((byte*)dest + got, chunk->data.data() + skip, count);
+        got += count;
+        impl->position += count;
+    }
+
+    return got;
+}
+
+bool CompressedSource::seek(size_t offset) {
+    if (!impl->reach(offset))
+        return false;
+
+    impl->position = offset;
+    return true;
+}
+
+size_t CompressedSource::tell() const {
+    return impl->position;
+}
+
+size_t CompressedSource::size() const {
+    if (!impl->indexed)
+        impl->fetch((size_t)-1); //decodes up to the end
+    return impl->total;
+}
+
+DEMO_NAMESPACE_END
@@ -0,0 +1,138 @@
+#include <jka/configstring_folder.h>
+
+DEMO_NAMESPACE_START
+
+namespace {
+
+/// Reads "<index> " from pos.
+/// @return position after the space, npos if there is no index
+size_t parseIndex(std::string_view command, size_t pos, int& index) {
+    size_t end = command.find(' ', pos);
+    if (end == std::string_view::npos || end == pos)
+        return std::string_view::npos;
+
+    index = 0;
+    for (size_t i = pos; i < end; ++i) {
+        if (command[i] < '0' || command[i] > '9')
+            return std::string_view::npos;
+        index = index * 10 + (command[i] - '0');
+    }
+
+    if (index >= MAX_CONFIGSTRINGS)
+        return std::string_view::npos;
+
+    return end + 1;
+}
+
+/// Strips quotes around a command argument, the closing one is optional.
+std::string_view unquote(std::string_view text) {
+    if (text.empty() || text[0] != '"')
+        return text;
+
+    text.remove_prefix(1);
+
+    size_t end = text.find('"');
+    if (end != std::string_view::npos)
+        text = text.substr(0, end);
+
+    return text;
+}
+
+}
+
+/*
+
+ConfigstringParser Implementation
+
+*/
+
+bool ConfigstringParser::parse(std::string_view command, int& index, std::string_view& value) {
+    size_t pos;
+
+    if (command.compare(0, 3, "cs ") == 0) {
+        if ((pos = parseIndex(command, 3, index)) == std::string_view::npos)
+            return false;
+
+        value = unquote(command.substr(pos));
+        return true;
+    }
+
+    //big configstring: bcs0 starts, bcs1 continues, bcs2 ends
+    if (command.size() < 5 || command.compare(0, 3, "bcs") != 0 || command[4] != ' ')
+        return false;
+
+    char fragment = command[3];
+    if (fragment < '0' || fragment > '2')
+        return false;
+
+    int fragmentIndex;
+    if ((pos = parseIndex(command, 5, fragmentIndex)) == std::string_view::npos) {
+        reset();
+        return false;
+    }
+
+    std::string_view part = command.substr(pos);
+    if (!part.empty() && part[0] == '"')
+        part.remove_prefix(1);
+    if (!part.empty() && part[part.size() - 1] == '"')
+        part.remove_suffix(1);
+
+    if (fragment == '0') {
+        bigIndex = fragmentIndex;
+        bigString.assign(part.data(), part.size());
+        return false;
+    }
+
+    if (bigIndex < 0 || fragmentIndex != bigIndex)
+        return false;
+
+    bigString.append(part.data(), part.size());
+
+    if (fragment == '1')
+        return false;
+
+    //last fragment, keep result until next call
+    index = bigIndex;
+    joined.swap(bigString);
+    value = joined;
+    reset();
+
+    return true;
+}
+
+void ConfigstringParser::reset() {
+    bigIndex = -1;
+    bigString.clear();
+}
+
+/*
+
+ConfigstringFolder Implementation
+
+*/
+
+ConfigstringFolder::ConfigstringFolder(Gamestate* gamestate)
+    : gamestate(gamestate), commandSequence(gamestate->getCommandSequence()) {
+}
+
+void ConfigstringFolder::update(Message* message) {
+    for (int i = 0; i < message->getInstructionsCount(); ++i) {
+        ServerCommand* command = message->getInstruction(i)->getServerCommand();
+
+        if (!command || command->getSequenceNumber() <= commandSequence)
+            continue;
+
+        apply(command);
+        commandSequence = command->getSequenceNumber();
+    }
+}
+
+void ConfigstringFolder::apply(const ServerCommand* command) {
+    int index;
+    std::string_view value;
+
+    if (parser.parse(command->getCommand(), index, value))
+        gamestate->setConfigstring(index, value);
+}
+
+DEMO_NAMESPACE_END
@@ -0,0 +1,220 @@
+#include <jka/configstring_timeline.h>
+#include <jka/demo_block.h>
+
+#include <algorithm>
+
+DEMO_NAMESPACE_START
+
+namespace {
+
+const InfoStringView EMPTY_INFO;
+
+}
+
+ConfigstringTimeline::ConfigstringTimeline() {
+    clear();
+}
+
+void ConfigstringTimeline::clear() {
+    versions.assign(MAX_CONFIGSTRINGS, std::vector<Version>());
+    infos.assign(MAX_CONFIGSTRINGS, std::vector<InfoStringView>());
+    infoParsed.assign(MAX_CONFIGSTRINGS, std::vector<bool>());
+    versionsCount = 0;
+    lastTime = -1;
+    parser.reset();
+    strings.clear();
+}
+
+bool ConfigstringTimeline::build(const Demo& demo) {
+    clear();
+
+    MessagePeek peek;
+    DemoBlock block;
+    int commandSequence = -1;
+    int time = -1;
+
+    for (int i = 0; i < demo.getMessageCount(); ++i) {
+        if (!demo.peekMessage(i, peek))
+            return false;
+
+        if (peek.serverTime >= 0)
+            time = peek.serverTime;
+
+        if (!peek.hasGamestate && !peek.serverCommands)
+            continue;
+
+        Message msg;
+        if (!demo.readRawMessage(i, block) || !decodeDemoBlock(msg, block))
+            return false;
+
+        for (int j = 0; j < msg.getInstructionsCount(); ++j) {
+            Instruction* instr = msg.getInstruction(j);
+
+            if (Gamestate* gamestate = instr->getGamestate()) {
+                addGamestate(i, time, *gamestate);
+                commandSequence = gamestate->getCommandSequence();
+            }
+            else if (ServerCommand* command = instr->getServerCommand()) {
+                //commands are resent until acknowledged
+                if (command->getSequenceNumber() <= commandSequence)
+                    continue;
+
+                addCommand(i, time, *command);
+                commandSequence = command->getSequenceNumber();
+            }
+        }
+    }
+
+    return true;
+}
+
+void ConfigstringTimeline::addGamestate(int messageId, int serverTime, const Gamestate& gamestate) {
+    const std::map<int, std::string_view>& configstrings = gamestate.getConfigStrings();
+
+    //indexes missing from gamestate are cleared
+    auto it = configstrings.begin();
+    for (int index = 0; index < MAX_CONFIGSTRINGS; ++index) {
+        if (it != configstrings.end() && it->first == index)
+            set(index, messageId, serverTime, (it++)->second);
+        else if (!versions[index].empty())
+            set(index, messageId, serverTime, std::string_view());
+    }
+
+    parser.reset();
+}
+
+void ConfigstringTimeline::addCommand(int messageId, int serverTime, const ServerCommand& command) {
+    int index;
+    std::string_view value;
+
+    if (parser.parse(command.getCommand(), index, value))
+        set(index, messageId, serverTime, value);
+}
+
+void ConfigstringTimeline::set(int index, int messageId, int serverTime, std::string_view value) {
+    if (index < 0 || index >= MAX_CONFIGSTRINGS)
+        return;
+
+    std::vector<Version>& list = versions[index];
+    if (list.empty() ? value.empty() : list.back().value == value)
+        return;
+
+    lastTime = std::max(lastTime, serverTime);
+
+    Version version;
+    version.messageId = messageId;
+    version.serverTime = lastTime;
+    version.value = strings.store(value);
+
+    list.push_back(version);
+    ++versionsCount;
+}
+
+int ConfigstringTimeline::findAt(int index, int serverTime) const {
+    if (index < 0 || index >= MAX_CONFIGSTRINGS)
+        return -1;
+
+    const std::vector<Version>& list = versions[index];
+    auto it = std::upper_bound(list.begin(), list.end(), serverTime,
+        [](int time, const Version& version) { return time < version.serverTime; });
+
+    return (int)(it - list.begin()) - 1;
+}
+
+int ConfigstringTimeline::findAtMessage(int index, int messageId) const {
+    if (index < 0 || index >= MAX_CONFIGSTRINGS)
+        return -1;
+
+    const std::vector<Version>& list = versions[index];
+    auto it = std::upper_bound(list.begin(), list.end(), messageId,
+        [](int id, const Version& version) { return id < version.messageId; });
+
+    return (int)(it - list.begin()) - 1;
+}
+
+std::string_view ConfigstringTimeline::valueAt(int index, int serverTime) const {
+    int v = findAt(index, serverTime);
+    return v >= 0 ? versions[index][v].value : std::string_view();
+}
+
+std::string_view ConfigstringTimeline::valueAtMessage(int index, int messageId) const {
+    int v = findAtMessage(index, messageId);
+    return v >= 0 ? versions[index][v].value : std::string_view();
+}
+
+const InfoStringView& ConfigstringTimeline::info(int index, int version) const {
+    if (version < 0)
+        return EMPTY_INFO;
+
+    std::vector<InfoStringView>& cache = infos[index];
+    std::vector<bool>& parsed = infoParsed[index];
+
+    if (cache.size() < versions[index].size()) {
+        cache.resize(versions[index].size());
+        parsed.resize(versions[index].size(), false);
+    }
+
+    if (!parsed[version]) {
+        cache[version].parse(versions[index][version].value);
+        parsed[version] = true;
+    }
+
+    return cache[version];
+}
+
+const InfoStringView& ConfigstringTimeline::infoAt(int index, int serverTime) const {
+    return info(index, findAt(index, serverTime));
+}
+
+const InfoStringView& ConfigstringTimeline::infoAtMessage(int index, int messageId) const {
+    return info(index, findAtMessage(index, messageId));
+}
+
+std::vector<std::string_view> ConfigstringTimeline::range(int first, int count, int serverTime) const {
+    std::vector<std::string_view> names(count);
+
+    for (int i = 0; i < count; ++i)
+        names[i] = valueAt(first + i, serverTime);
+
+    return names;
+}
+
+std::vector<std::string_view> ConfigstringTimeline::modelNames(int serverTime) const {
+    return range(CS_MODELS, MAX_MODELS, serverTime);
+}
+
+std::vector<std::string_view> ConfigstringTimeline::soundNames(int serverTime) const {
+    return range(CS_SOUNDS, MAX_SOUNDS, serverTime);
+}
+
+std::vector<std::string_view> ConfigstringTimeline::playerNames(int serverTime) const {
+    std::vector<std::string_view> names(MAX_CLIENTS);
+
+    for (int i = 0; i < MAX_CLIENTS; ++i)
+        names[i] = infoAt(CS_PLAYERS + i, serverTime).value("n");
+
+    return names;
+}
+
+std::string_view ConfigstringTimeline::modelName(int modelIndex, int serverTime) const {
+    if (modelIndex < 0 || modelIndex >= MAX_MODELS)
+        return std::string_view();
+
+    return valueAt(CS_MODELS + modelIndex, serverTime);
+}
+
+std::string_view ConfigstringTimeline::soundName(int soundIndex, int serverTime) const {
+    if (soundIndex < 0 || soundIndex >= MAX_SOUNDS)
+        return std::string_view();
+
+    return valueAt(CS_SOUNDS + soundIndex, serverTime);
+}
+
+std::string_view ConfigstringTimeline::playerName(int clientNum, int serverTime) const {
+    if (clientNum < 0 || clientNum >= MAX_CLIENTS)
+        return std::string_view();
+
+    return infoAt(CS_PLAYERS + clientNum, serverTime).value("n");
+}
+
+DEMO_NAMESPACE_END
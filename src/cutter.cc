@@ -0,0 +1,129 @@
+#include <jka/cutter.h>
+#include <jka/configstring_folder.h>
+#include <jka/demo_block.h>
+#include <jka/demo_writer.h>
+#include <jka/snapshot_resolver.h>
+
+#include <fstream>
+
+DEMO_NAMESPACE_START
+
+namespace {
+
+Gamestate* findGamestate(Message& message) {
+    for (int i = 0; i < message.getInstructionsCount(); ++i)
+        if (message.getInstruction(i)->getType() == INSTR_GAMESTATE)
+            return message.getInstruction(i)->getGamestate();
+
+    return 0;
+}
+
+}
+
+DemoCutter::DemoCutter(const Demo& demo) : demo(demo), firstMessage(-1), lastMessage(-1) {
+}
+
+bool DemoCutter::cut(std::string_view filename, int fromTime, int toTime) {
+    std::ofstream os(std::string(filename), std::ios::binary);
+
+    if (!os.is_open())
+        return false;
+
+    return cut(os, fromTime, toTime) && os.good();
+}
+
+bool DemoCutter::cut(std::ostream& os, int fromTime, int toTime) {
+    firstMessage = lastMessage = -1;
+
+    //locate window start and gamestate in effect there, peeking is enough
+    int count = demo.getMessageCount();
+    int gamestateId = -1;
+    int first = -1;
+    MessagePeek peek;
+
+    for (int i = 0; i < count && first < 0; ++i) {
+        if (!demo.peekMessage(i, peek))
+            return false;
+
+        if (peek.hasGamestate)
+            gamestateId = i;
+        if (peek.hasSnapshot && peek.serverTime >= fromTime)
+            first = i;
+    }
+
+    if (first < 0 || gamestateId < 0 || (toTime >= 0 && peek.serverTime > toTime))
+        return false;
+
+    int firstSequence = peek.sequenceNumber;
+
+    DemoBlock block;
+    Message gamestateMessage;
+
+    if (!demo.readRawMessage(gamestateId, block) || !decodeDemoBlock(gamestateMessage, block))
+        return false;
+
+    Gamestate* gamestate = findGamestate(gamestateMessage);
+    if (!gamestate)
+        return false;
+
+    //replay messages left out: fold configstrings, resolve snapshots
+    SnapshotResolver resolver;
+    ConfigstringFolder folder(gamestate);
+
+    resolver.update(&gamestateMessage);
+
+    for (int i = gamestateId + 1; i < first; ++i) {
+        Message msg;
+
+        if (!demo.readRawMessage(i, block) || !decodeDemoBlock(msg, block))
+            return false;
+
+        folder.update(&msg);
+        resolver.update(&msg);
+    }
+
+    DemoWriter writer(os);
+    writer.setSequenceShift(2 - firstSequence); //gamestate is 1, window starts at 2
+
+    if (gamestateId != first) {
+        gamestate->setCommandSequence(folder.getCommandSequence());
+        gamestateMessage.setSeqNumber(firstSequence - 1);
+        writer.writeMessage(gamestateMessage);
+    }
+
+    int i = first;
+    for (; i < count; ++i) {
+        if (!demo.peekMessage(i, peek))
+            break;
+
+        if (toTime >= 0 && peek.hasSnapshot && peek.serverTime > toTime)
+            break;
+
+        if (!demo.readRawMessage(i, block))
+            return false;
+
+        int base = peek.deltaSequence();
+
+        if (base < 0 || base >= firstSequence) {
+            writer.writeBlock(block);
+            continue;
+        }
+
+        //delta against a message left out, store it uncompressed
+        Message msg;
+
+        if (!decodeDemoBlock(msg, block) || !resolver.uncompress(&msg))
+            return false;
+
+        writer.writeMessage(msg);
+    }
+
+    writer.writeEnd();
+
+    firstMessage = first;
+    lastMessage = i;
+
+    return writer.isGood();
+}
+
+DEMO_NAMESPACE_END
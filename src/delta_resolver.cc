@@ -0,0 +1,257 @@
+#include <jka/delta_resolver.h>
+#include <jka/state.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+DEMO_NAMESPACE_START
+
+namespace {
+
+int findField(const Field* fields, int count, const std::string& name) {
+    for (int i = 0; i < count; ++i)
+        if (name == fields[i]._name)
+            return i;
+
+    return -1;
+}
+
+/// Copies tracked fields set in state over values.
+void applyFields(const State& state, const std::vector<int>& fields, int* values) {
+    for (size_t k = 0; k < fields.size(); ++k)
+        if (state.isAttributeSet(fields[k]))
+            values[k] = state.getAttributeInt(fields[k]);
+}
+
+}
+
+int DeltaResolver::Frame::find(int entityNum) const {
+    auto it = std::lower_bound(entities.begin(), entities.end(), entityNum);
+
+    if (it == entities.end() || *it != entityNum)
+        return -1;
+
+    return (int)(it - entities.begin());
+}
+
+DeltaResolver::DeltaResolver(const std::vector<std::string>& entityNames, const std::vector<std::string>& playerNames) {
+    for (const std::string& name : entityNames) {
+        int id = findEntityField(name);
+        if (id < 0)
+            throw DemoException("unknown entity netfield " + name);
+        entityFields.push_back(id);
+    }
+
+    for (const std::string& name : playerNames) {
+        PlayerField field;
+        if (!parsePlayerField(name, field))
+            throw DemoException("unknown player netfield " + name);
+        playerFields.push_back(field);
+    }
+
+    reset();
+}
+
+int DeltaResolver::findEntityField(const std::string& name) {
+    return findField(EntityNetfield, sizeof(EntityNetfield) / sizeof(Field), name);
+}
+
+int DeltaResolver::findPlayerField(const std::string& name) {
+    return findField(PlayerNetfield, sizeof(PlayerNetfield) / sizeof(Field), name);
+}
+
+bool DeltaResolver::parsePlayerField(const std::string& name, PlayerField& field) {
+    static const struct {
+        const char* prefix;
+        PlayerArray array;
+    } arrays[] = {
+        { "stats[", PLAYER_STATS },
+        { "persistant[", PLAYER_PERSISTANT },
+        { "ammo[", PLAYER_AMMO },
+        { "powerups[", PLAYER_POWERUPS }
+    };
+
+    field.array = PLAYER_FIELD;
+    field.id = findPlayerField(name);
+    if (field.id >= 0)
+        return true;
+
+    for (const auto& entry : arrays) {
+        size_t length = strlen(entry.prefix);
+        if (name.compare(0, length, entry.prefix) != 0 || name[name.size() - 1] != ']')
+            continue;
+
+        std::string index = name.substr(length, name.size() - length - 1);
+        if (index.empty() || index.find_first_not_of("0123456789") != std::string::npos)
+            return false;
+
+        field.array = entry.array;
+        field.id = atoi(index.c_str());
+        return field.id < 16; //MAX_STATS, MAX_PERSISTANT, MAX_WEAPONS, MAX_POWERUPS
+    }
+
+    return false;
+}
+
+void DeltaResolver::applyPlayer(const PlayerState& state, int* values) const {
+    for (size_t k = 0; k < playerFields.size(); ++k) {
+        const PlayerField& field = playerFields[k];
+        const std::map<int, int>* array = 0;
+
+        switch (field.array) {
+        case PLAYER_FIELD:
+            if (state.isAttributeSet(field.id))
+                values[k] = state.getAttributeInt(field.id);
+            continue;
+        case PLAYER_STATS:
+            array = &state.getStats();
+            break;
+        case PLAYER_PERSISTANT:
+            array = &state.getPersistant();
+            break;
+        case PLAYER_AMMO:
+            array = &state.getAmmo();
+            break;
+        case PLAYER_POWERUPS:
+            array = &state.getPowerups();
+            break;
+        }
+
+        auto it = array->find(field.id);
+        if (it != array->end())
+            values[k] = it->second;
+    }
+}
+
+void DeltaResolver::reset() {
+    baselines.assign(MAX_GENTITIES * entityFields.size(), 0);
+
+    for (int i = 0; i < PACKET_BACKUP; ++i)
+        frames[i].sequenceNumber = -1;
+}
+
+void DeltaResolver::setBaselines(const Gamestate& gamestate) {
+    reset();
+
+    const std::map<int, EntityState>& base = gamestate.getBaseEntities();
+    for (auto it = base.begin(); it != base.end(); ++it) {
+        if (it->first < 0 || it->first >= MAX_GENTITIES)
+            continue;
+
+        applyFields(it->second, entityFields, &baselines[it->first * entityFields.size()]);
+    }
+}
+
+const DeltaResolver::Frame* DeltaResolver::update(Message* message) {
+    const Frame* resolved = 0;
+
+    if (!message)
+        return resolved;
+
+    for (int i = 0; i < message->getInstructionsCount(); ++i) {
+        Instruction* instr = message->getInstruction(i);
+
+        if (Gamestate* gamestate = instr->getGamestate())
+            setBaselines(*gamestate); //new delta chain
+        else if (Snapshot* snapshot = instr->getSnapshot())
+            resolved = resolve(message->getSeqNumber(), *snapshot);
+    }
+
+    return resolved;
+}
+
+const DeltaResolver::Frame* DeltaResolver::resolve(int sequenceNumber, const Snapshot& snapshot) {
+    Frame& frame = frames[sequenceNumber & (PACKET_BACKUP - 1)];
+    frame.sequenceNumber = -1;
+
+    const Frame* base = 0;
+    if (snapshot.getDeltanum()) {
+        base = find(sequenceNumber - snapshot.getDeltanum());
+        if (!base)
+            return 0; //base not received
+    }
+
+    size_t fieldsCount = entityFields.size();
+
+    frame.serverTime = snapshot.getServertime();
+    frame.entities.clear();
+    frame.values.clear();
+
+    //merge sent entities with base ones, both sorted by number
+    const std::map<int, EntityState>& sent = snapshot.getEntities();
+    auto it = sent.begin();
+    size_t b = 0;
+    size_t baseCount = base ? base->entities.size() : 0;
+
+    while (it != sent.end() || b < baseCount) {
+        int number;
+        const int* from;
+
+        if (it == sent.end() || (b < baseCount && base->entities[b] < it->first)) {
+            //unchanged since base
+            number = base->entities[b];
+            from = &base->values[b * fieldsCount];
+            ++b;
+
+            frame.entities.push_back(number);
+            frame.values.insert(frame.values.end(), from, from + fieldsCount);
+            continue;
+        }
+
+        number = it->first;
+        const EntityState& state = it->second;
+        bool inBase = (b < baseCount && base->entities[b] == number);
+
+        if (inBase)
+            ++b;
+        ++it;
+
+        if (state.isRemoved() || number < 0 || number >= MAX_GENTITIES)
+            continue;
+
+        from = inBase ? &base->values[(b - 1) * fieldsCount] : &baselines[number * fieldsCount];
+
+        frame.entities.push_back(number);
+        frame.values.insert(frame.values.end(), from, from + fieldsCount);
+        applyFields(state, entityFields, &frame.values[frame.values.size() - fieldsCount]);
+    }
+
+    if (base)
+        frame.player = base->player;
+    else
+        frame.player.assign(playerFields.size(), 0);
+
+    if (const PlayerState* player = snapshot.getPlayerstate())
+        applyPlayer(*player, frame.player.data());
+
+    frame.sequenceNumber = sequenceNumber;
+    return &frame;
+}
+
+const DeltaResolver::Frame* DeltaResolver::find(int sequenceNumber) const {
+    const Frame& frame = frames[sequenceNumber & (PACKET_BACKUP - 1)];
+
+    if (sequenceNumber < 0 || frame.sequenceNumber != sequenceNumber)
+        return 0;
+
+    return &frame;
+}
+
+float DeltaResolver::getFloat(const Frame& frame, int i, int field) const {
+    int bits = get(frame, i, field);
+    float value;
+
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+float DeltaResolver::getPlayerFloat(const Frame& frame, int field) const {
+    int bits = getPlayer(frame, field);
+    float value;
+
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+DEMO_NAMESPACE_END
@@ -1,25 +1,52 @@
 #include <jka/demo.h>
+#include <jka/bg_defs.h>
+#include <jka/configstring_folder.h>
+#include <jka/demo_block.h>
 #include <jka/defs.h>
 
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <exception>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
 DEMO_NAMESPACE_START
 
+namespace {
+
+const int SAVE_BATCH = 4096;        //messages encoded before writing them out
+const int SAVE_PARALLEL_MIN = 64;   //fewer dirty messages are encoded on calling thread
+
+/// Reads a server time configstring (CS_LEVEL_START_TIME, CS_WARMUP).
+bool parseTime(std::string_view value, int& time) {
+    const char* end = value.data() + value.size();
+    return !value.empty() && std::from_chars(value.data(), end, time).ec == std::errc();
+}
+
+}
+
 class DemoImpl {
 public:
-    struct DemoRef { //12 bytes
+    struct DemoRef { //16 bytes
         int      offset;
+        int      length; //message data length, without 8 bytes header
         Message* message;
         int      vehicleStatus;
 
-        DemoRef() : message(0), vehicleStatus(VEHICLE_NOT_CHECKED) {
+        DemoRef() : length(0), message(0), vehicleStatus(VEHICLE_NOT_CHECKED) {
         };
 
     };
 
-    std::string            demoName;
-    std::ifstream          demoFile;
-    std::vector<DemoRef>   messages;
+    std::string                 demoName;
+    std::unique_ptr<DemoSource> source;
+    std::vector<byte>           scratch; //message data when source cannot be viewed
+    std::vector<DemoRef>        messages;
     bool                   loaded;
     bool                   analysed;
+    int                    saveThreads;
 
     struct MapRef {
         int         messageId;
@@ -42,31 +69,137 @@ public:
 
     bool isValidIndex(int id);
 
+    const byte* readMessageData(int id, int& sequenceNumber, int& length);
+
+    bool isClean(int id) const;
+    void copyRange(size_t begin, size_t end, std::ostream& os);
+    void encodeMessages(const std::vector<int>& ids, std::vector<std::string>& encoded) const;
+
 };
 
 bool DemoImpl::isValidIndex(int id) {
     return ((id >= 0) && (id < (int)messages.size()));
 }
 
+//raw data of message, straight from the source view if memory backed
+const byte* DemoImpl::readMessageData(int id, int& sequenceNumber, int& length) {
+    int header[2];
+    size_t offset = messages[id].offset;
+
+    if (!source->seek(offset) || source->read(header, sizeof(header)) != sizeof(header))
+        return 0;
+
+    sequenceNumber = header[0];
+    length = header[1];
+
+    if (length < 0 || length > MAX_MSGLEN)
+        return 0;
+
+    const byte* data = source->view(offset + sizeof(header), length);
+    if (data)
+        return data;
+
+    if (scratch.size() < (size_t)MAX_MSGLEN)
+        scratch.resize(MAX_MSGLEN);
+
+    if (source->read(scratch.data(), length) != (size_t)length)
+        return 0;
+
+    return scratch.data();
+}
+
+//message can be copied from source as is
+bool DemoImpl::isClean(int id) const {
+    const Message* message = messages[id].message;
+    return !message || !message->isLoad() || !message->isModified();
+}
+
+//copies source bytes [begin, end) to output
+void DemoImpl::copyRange(size_t begin, size_t end, std::ostream& os) {
+    const byte* data = source->view(begin, end - begin);
+    if (data) {
+        os.write((const char*)data, end - begin);
+        return;
+    }
+
+    const size_t blockSize = 1 << 20;
+    std::vector<byte> block(std::min(blockSize, end - begin));
+
+    source->seek(begin);
+    while (begin < end) {
+        size_t got = source->read(block.data(), std::min(block.size(), end - begin));
+        if (!got)
+            break;
+
+        os.write((const char*)block.data(), got);
+        begin += got;
+    }
+}
+
+//encodes given messages into separate buffers, on several threads if worth it
+void DemoImpl::encodeMessages(const std::vector<int>& ids, std::vector<std::string>& encoded) const {
+    int count = (int)ids.size();
+    encoded.resize(count);
+
+    int threads = saveThreads > 0 ? saveThreads : (int)std::thread::hardware_concurrency();
+    if (count < SAVE_PARALLEL_MIN)
+        threads = 1;
+    threads = std::max(1, std::min(threads, count));
+
+    //Huffman tree is shared read-only, message buffer is per thread
+    std::atomic<int> next(0);
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    auto worker = [&]() {
+        std::ostringstream os(std::ios::binary);
+
+        int index;
+        while ((index = next.fetch_add(1)) < count) {
+            try {
+                os.str(std::string());
+                messages[ids[index]].message->save(os);
+                encoded[index] = os.str();
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error)
+                    error = std::current_exception();
+                next = count; //stop other workers early
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threads; ++i)
+        pool.push_back(std::thread(worker));
+
+    worker(); //calling thread works too
+
+    for (std::vector<std::thread>::iterator it = pool.begin(); it != pool.end(); ++it)
+        it->join();
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
 void Demo::saveMessage(int id, std::ofstream& os) const {
     if (!impl->isValidIndex(id))
         return;
 
-    if (impl->messages[id].message && impl->messages[id].message->isLoad()) { //if message is loaded, write it from memory
+    if (!impl->isClean(id)) { //if message was modified, write it from memory
         impl->messages[id].message->save(os);
     }
-    else { //otherwise copy from source file
-        impl->demoFile.seekg(impl->messages[id].offset, impl->demoFile.beg);
-
+    else { //otherwise copy from source
         int snumber, msglen;
-        char buffer[MAX_MSGLEN];
-        impl->demoFile.read((char*)&snumber, sizeof(snumber));
-        impl->demoFile.read((char*)&msglen, sizeof(msglen));
-        impl->demoFile.read((char*)&buffer, msglen);
+        const byte* buffer = impl->readMessageData(id, snumber, msglen);
+
+        if (!buffer)
+            return;
 
         os.write((char*)&snumber, sizeof(snumber));
         os.write((char*)&msglen, sizeof(msglen));
-        os.write((char*)&buffer, msglen);
+        os.write((char*)buffer, msglen);
     }
 }
 
@@ -74,55 +207,68 @@ Demo::Demo() : impl(new DemoImpl())
 {
     impl->loaded = false;
     impl->analysed = false;
+    impl->saveThreads = 0;
 }
 
 Demo::~Demo() {
     close();
-    delete impl;
 }
 
-bool Demo::open(const char* filename, bool analysis) {
-    (void)analysis;
+bool Demo::open(std::string_view filename, bool analysis) {
     if (isOpen())
         close();
 
-    impl->demoFile.open(filename, std::ios::binary);
+    std::unique_ptr<DemoSource> source = openDemoSource(std::string(filename));
+
+    if (!source || !open(std::move(source), analysis))
+        return false;
+
+    impl->demoName = std::string(filename);
+    return true;
+}
 
-    if (!impl->demoFile.is_open())
+bool Demo::openMemory(const void* data, size_t size, bool analysis) {
+    return open(std::unique_ptr<DemoSource>(new MemorySource(data, size)), analysis);
+}
+
+bool Demo::open(std::unique_ptr<DemoSource> source, bool analysis) {
+    (void)analysis;
+    if (isOpen())
+        close();
+
+    if (!source)
         return (impl->loaded = false);
 
-    //log end offset
-    impl->demoFile.seekg(0, std::ios_base::end);
-    int end = (int)impl->demoFile.tellg();
+    impl->source = std::move(source);
 
-    impl->demoFile.seekg(0, impl->demoFile.beg);
+    //end is found by reading, compressed sources learn their size on the way
+    size_t offset = 0;
 
-    int len;
+    int header[2]; //sequence number, length
     DemoImpl::DemoRef ref; //dummy ref
 
-    do {
-        ref.offset = (int)impl->demoFile.tellg();
-        ref.message = 0;
+    impl->source->seek(0);
 
-        if (impl->demoFile.eof())
-            continue;
+    while (true) {
+        if (impl->source->read(header, sizeof(header)) != sizeof(header))
+            break;
 
-        if (!impl->demoFile.fail())
-            impl->demoFile.seekg(4, impl->demoFile.cur);
-        if (!impl->demoFile.fail())
-            impl->demoFile.read((char*)&len, 4);
+        int len = header[1];
 
-        if ((int)impl->demoFile.tellg() > end - len)
+        if (len == -1)
+            break; //ending message
+
+        if (len < 0 || !impl->source->seek(offset + sizeof(header) + len))
             break; //truncated demo
 
-        if (!impl->demoFile.fail() && (len != -1)) {
-            impl->demoFile.seekg(len, impl->demoFile.cur);
-            impl->messages.push_back(ref);
-        }
+        ref.offset = (int)offset;
+        ref.length = len;
+        ref.message = 0;
+        impl->messages.push_back(ref);
 
-    } while (!impl->demoFile.eof() && !impl->demoFile.fail() && (len != -1));
+        offset += sizeof(header) + len;
+    }
 
-    impl->demoFile.clear();
     impl->analysed = false;
 
     return (impl->loaded = true);
@@ -282,20 +428,12 @@ void Demo::analyse() {
 
                 assert(gamestate);
 
-                //get map name from configstring
-                std::string s = gamestate->getConfigstring(0);
-
-                int startIndex = (int)s.find("\\mapname\\");
-                startIndex += 9;
+                //get map name from server info configstring
+                std::string_view mapName = gamestate->getConfigstringInfo(CS_SERVERINFO).value("mapname");
 
-                if ((size_t)startIndex >= s.size())
+                if (mapName.empty())
                     continue; //not found or wrong format
 
-                int endIndex = (int)s.find_first_of('\\', startIndex);
-
-                if ((size_t)endIndex == s.size())
-                    continue; //not found (wrong format)
-
                 //log ending time for previous map
                 int currentTime = lastSnapTime;
                 int mapTime;
@@ -306,7 +444,7 @@ void Demo::analyse() {
 
                 //insert new map
                 impl->maps.push_back(DemoImpl::MapRef(messageId,
-                    s.substr(startIndex, endIndex - startIndex),
+                    std::string(mapName),
                     false));
 
                 //log beginning time for new map
@@ -356,7 +494,7 @@ void Demo::analyse() {
     impl->analysed = true;
 }
 
-bool Demo::isOpen() const {
+bool Demo::isOpen() const noexcept {
     return impl->loaded;
 }
 
@@ -365,7 +503,7 @@ void Demo::close() {
         return;
 
     impl->loaded = false;
-    impl->demoFile.close();
+    impl->source.reset();
     impl->demoName.clear();
 
     for (std::vector<DemoImpl::DemoRef>::iterator it = impl->messages.begin();
@@ -377,14 +515,54 @@ void Demo::close() {
     impl->maps.clear();
 }
 
-bool Demo::save(const char* filename, bool endSign) const {
-    std::ofstream vystup(filename, std::ios::binary);
+void Demo::setSaveThreads(int count) {
+    impl->saveThreads = count;
+}
+
+bool Demo::save(std::string_view filename, bool endSign) const {
+    std::ofstream vystup(std::string(filename), std::ios::binary);
 
     if (!vystup.is_open())
         return false;
 
-    for (int i = 0; i < getMessageCount(); ++i)
-        saveMessage(i, vystup);
+    //only modified messages are encoded again, runs of other messages
+    //which are contiguous in source are copied at once
+    int count = getMessageCount();
+    std::vector<int> dirty;
+    std::vector<std::string> encoded;
+
+    for (int batch = 0; batch < count; batch += SAVE_BATCH) {
+        int batchEnd = std::min(count, batch + SAVE_BATCH);
+
+        //messages are independent, encode all dirty ones of batch at once
+        dirty.clear();
+        for (int i = batch; i < batchEnd; ++i)
+            if (!impl->isClean(i))
+                dirty.push_back(i);
+
+        impl->encodeMessages(dirty, encoded);
+
+        //then write batch in order
+        size_t next = 0;
+        int i = batch;
+
+        while (i < batchEnd) {
+            if (next < dirty.size() && dirty[next] == i) {
+                vystup.write(encoded[next].data(), encoded[next].size());
+                ++next;
+                ++i;
+                continue;
+            }
+
+            size_t begin = impl->messages[i].offset;
+            size_t end = begin + 8 + impl->messages[i].length;
+
+            for (++i; i < batchEnd && impl->isClean(i) && (size_t)impl->messages[i].offset == end; ++i)
+                end += 8 + impl->messages[i].length;
+
+            impl->copyRange(begin, end, vystup);
+        }
+    }
 
     if (endSign) {
         int end = -1;
@@ -400,7 +578,11 @@ void Demo::loadMessage(int id) {
     if (isMessageLoaded(id))
         return;
 
-    impl->demoFile.seekg(impl->messages[id].offset, impl->demoFile.beg);
+    int seq, len;
+    const byte* data = impl->readMessageData(id, seq, len);
+
+    if (!data)
+        return;
 
     //our vehicle magic
     if (impl->analysed) {
@@ -415,12 +597,12 @@ void Demo::loadMessage(int id) {
     }
 
     if (impl->analysed) { //we did analysis, we can believe clean fast way
-        impl->messages[id].message->load(impl->demoFile);
+        impl->messages[id].message->load(seq, data, len);
     }
     else {
         //not analysed, we must try eventually both variants (without and with vehicles)
         try {
-            impl->messages[id].message->load(impl->demoFile);
+            impl->messages[id].message->load(seq, data, len);
         }
         catch (std::exception& e) {
             if (Message::forceVehicleLoad) {
@@ -429,8 +611,7 @@ void Demo::loadMessage(int id) {
             else { //try again with forcing vehicle load
                 Message::forceVehicleLoad = true;
                 impl->messages[id].message->clear();
-                impl->demoFile.seekg(impl->messages[id].offset, impl->demoFile.beg);
-                impl->messages[id].message->load(impl->demoFile);
+                impl->messages[id].message->load(seq, data, len);
                 Message::forceVehicleLoad = false;
             }
         }
@@ -465,6 +646,95 @@ void Demo::unloadMessage(int id) {
     impl->messages[id].message = 0;
 }
 
+bool Demo::peekMessage(int id, MessagePeek& peek) const {
+    if (!isOpen() || !impl->isValidIndex(id))
+        return false;
+
+    peek = MessagePeek();
+
+    if (isMessageLoaded(id)) { //answer from memory, message may differ from file
+        Message* msg = impl->messages[id].message;
+        peek.sequenceNumber = msg->getSeqNumber();
+
+        for (int i = 0; i < msg->getInstructionsCount(); ++i) {
+            Instruction* instr = msg->getInstruction(i);
+
+            if (instr->getType() == INSTR_SERVERCOMMAND) {
+                ++peek.serverCommands;
+            }
+            else if (instr->getType() == INSTR_MAPCHANGE) {
+                peek.hasMapChange = true;
+            }
+            else if (instr->getType() == INSTR_GAMESTATE) {
+                peek.hasGamestate = true;
+                break;
+            }
+            else if (instr->getType() == INSTR_SNAPSHOT) {
+                peek.hasSnapshot = true;
+                peek.serverTime = instr->getSnapshot()->getServertime();
+                peek.deltaNum = instr->getSnapshot()->getDeltanum();
+                break;
+            }
+        }
+
+        return true;
+    }
+
+    int msglen = 0;
+    const byte* data = impl->readMessageData(id, peek.sequenceNumber, msglen);
+
+    if (!data)
+        return false;
+
+    Message::buffer.load(data, msglen);
+
+    try {
+        Message::buffer.readBits(SIZE_32BITS); //reliable acknowledge
+
+        bool done = false;
+
+        while (!done) {
+            switch (Message::buffer.readBits(SIZE_8BITS)) {
+            case svc_EOF:
+                done = true;
+                break;
+            case svc_bad:
+            case svc_nop:
+                break;
+            case svc_serverCommand:
+                //same fields as ServerCommand::Load, text is skipped
+                Message::buffer.readBits(SIZE_32BITS);
+                Message::buffer.skipString(true);
+                ++peek.serverCommands;
+                break;
+            case svc_mapchange:
+                peek.hasMapChange = true;
+                break;
+            case svc_gamestate:
+                peek.hasGamestate = true;
+                done = true;
+                break;
+            case svc_snapshot:
+                //same leading fields as Snapshot::Load
+                peek.hasSnapshot = true;
+                peek.serverTime = Message::buffer.readBits(SIZE_32BITS);
+                peek.deltaNum = Message::buffer.readBits(SIZE_8BITS);
+                done = true;
+                break;
+            default:
+                throw DemoException("unknown message type");
+            }
+        }
+    }
+    catch (std::exception&) {
+        Message::buffer.clean();
+        return false;
+    }
+
+    Message::buffer.clean();
+    return true;
+}
+
 Message* Demo::getMessage(int id) {
     if (!isOpen())
         return 0;
@@ -481,6 +751,32 @@ Message* Demo::getMessage(int id) {
     return impl->messages[id].message;
 }
 
+bool Demo::isMessageModified(int id) const {
+    return isMessageLoaded(id) && impl->messages[id].message->isModified();
+}
+
+bool Demo::readRawMessage(int id, DemoBlock& block) const {
+    if (!isOpen() || !impl->isValidIndex(id))
+        return false;
+
+    const byte* data = impl->readMessageData(id, block.sequenceNumber, block.length);
+    if (!data)
+        return false;
+
+    block.data.assign(data, data + block.length);
+    return true;
+}
+
+std::unique_ptr<Message> Demo::takeMessage(int id) {
+    if (!getMessage(id))
+        return std::unique_ptr<Message>();
+
+    std::unique_ptr<Message> msg(impl->messages[id].message);
+    impl->messages[id].message = 0;
+
+    return msg;
+}
+
 int Demo::getMessageCount() const {
     return (int)impl->messages.size();
 }
@@ -528,16 +824,14 @@ int DemoImpl::getStartTime(Demo* demo, int mapIndex) {
     if (demo->isMapRestart(mapIndex)) {
         //ok map restart, we should find new map time in server command
         ServerCommand* command;
-        std::string str;
+        ConfigstringParser parser;
+        int index;
+        std::string_view value;
         for (int i = 0; i < firstMessage->getInstructionsCount(); ++i) {
             if ((command = firstMessage->getInstruction(i)->getServerCommand())) {
-                str = command->getCommand();
-                if (str.substr(0, 6) == "cs 21 ") {
-                    std::stringstream stream(str.substr(7, str.size() - 7 - 2));
-                    if ((stream >> ret)) {
-                        return ret;
-                    }
-                }
+                if (parser.parse(command->getCommand(), index, value) && index == CS_LEVEL_START_TIME
+                    && parseTime(value, ret))
+                    return ret;
             }
         }
 
@@ -546,14 +840,13 @@ int DemoImpl::getStartTime(Demo* demo, int mapIndex) {
     }
     else { //new map begins
         // we find new time directly in gamestate
-        //configstring 21
+        //CS_LEVEL_START_TIME
         Gamestate* gamestate;
         for (int i = 0; i < firstMessage->getInstructionsCount(); ++i) {
             gamestate = firstMessage->getInstruction(i)->getGamestate();
 
             if (gamestate) {
-                std::stringstream stream(gamestate->getConfigstring(21));
-                if (!(stream >> ret))
+                if (!parseTime(gamestate->getConfigstring(CS_LEVEL_START_TIME), ret))
                     throw DemoException("gamestate time extraction failed");
                 return ret;
             }
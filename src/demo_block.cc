@@ -0,0 +1,50 @@
+#include <jka/demo_block.h>
+
+DEMO_NAMESPACE_START
+
+bool readDemoBlock(std::istream& is, DemoBlock& block) {
+    int header[2];
+
+    is.read((char*)header, sizeof(header));
+    if (is.gcount() != sizeof(header))
+        return false;
+
+    block.sequenceNumber = header[0];
+    block.length = header[1];
+
+    if (block.length == -1) //ending message
+        return false;
+
+    if (block.length < 0 || block.length > MAX_MSGLEN)
+        throw DemoException("message length out of range");
+
+    block.data.resize(block.length);
+    is.read((char*)block.data.data(), block.length);
+
+    return is.gcount() == block.length; //truncated demo otherwise
+}
+
+void writeDemoBlock(std::ostream& os, const DemoBlock& block) {
+    os.write((char*)&block.sequenceNumber, sizeof(block.sequenceNumber));
+    os.write((char*)&block.length, sizeof(block.length));
+    os.write((char*)block.data.data(), block.length);
+}
+
+bool decodeDemoBlock(Message& message, const DemoBlock& block) {
+    Message::forceVehicleLoad = false;
+
+    try {
+        message.load(block.sequenceNumber, block.data.data(), block.length);
+    }
+    catch (std::exception&) {
+        //try again with forcing vehicle load
+        Message::forceVehicleLoad = true;
+        message.clear();
+        message.load(block.sequenceNumber, block.data.data(), block.length);
+        Message::forceVehicleLoad = false;
+    }
+
+    return message.isLoad();
+}
+
+DEMO_NAMESPACE_END
@@ -0,0 +1,167 @@
+#include <jka/demo_pipeline.h>
+#include <jka/bounded_queue.h>
+#include <jka/snapshot_resolver.h>
+
+#include <atomic>
+#include <exception>
+#include <thread>
+
+DEMO_NAMESPACE_START
+
+class DemoPipelineImpl {
+public:
+    struct Item {
+        int                       id;
+        std::shared_ptr<Message>  message;
+        std::shared_ptr<Snapshot> resolved;
+
+        Item() : id(-1) {}
+        Item(int id, const std::shared_ptr<Message>& message, const std::shared_ptr<Snapshot>& resolved)
+            : id(id), message(message), resolved(resolved) {}
+    };
+
+    struct Stage {
+        DemoAnalyzer*                       analyzer;
+        int                                 queueCapacity;
+        std::unique_ptr<BoundedQueue<Item>> queue; //null for inline analyzers
+        std::thread                         thread;
+        std::exception_ptr                  error;
+
+        Stage(DemoAnalyzer* analyzer, int queueCapacity)
+            : analyzer(analyzer), queueCapacity(queueCapacity) {}
+    };
+
+    explicit DemoPipelineImpl(Demo& demo) : demo(demo), failed(false) {}
+
+    void work(Stage* stage);
+    void fail();
+
+    Demo&                               demo;
+    std::vector<std::unique_ptr<Stage>> stages;
+    std::atomic<bool>                   failed; //an analyzer threw, every stage stops
+};
+
+void DemoPipelineImpl::work(Stage* stage) {
+    Item item;
+
+    try {
+        stage->analyzer->begin();
+        while (!failed && stage->queue->pop(item))
+            stage->analyzer->onMessage(item.id, item.message, item.resolved);
+        if (!failed)
+            stage->analyzer->end();
+    }
+    catch (...) {
+        stage->error = std::current_exception();
+        fail();
+    }
+}
+
+//stops decoding and the other analyzers, queued messages are dropped
+void DemoPipelineImpl::fail() {
+    failed = true;
+
+    for (size_t i = 0; i < stages.size(); ++i)
+        if (stages[i]->queue)
+            stages[i]->queue->close();
+}
+
+DemoPipeline::DemoPipeline(Demo& demo) : impl(new DemoPipelineImpl(demo)) {
+}
+
+DemoPipeline::~DemoPipeline() {
+}
+
+void DemoPipeline::addAnalyzer(DemoAnalyzer* analyzer, bool threaded, int queueCapacity) {
+    assert(analyzer);
+
+    impl->stages.push_back(std::unique_ptr<DemoPipelineImpl::Stage>(
+        new DemoPipelineImpl::Stage(analyzer, threaded ? std::max(1, queueCapacity) : 0)));
+}
+
+void DemoPipeline::run(int first, int last) {
+    typedef DemoPipelineImpl::Stage Stage;
+    typedef DemoPipelineImpl::Item  Item;
+
+    if (last < 0 || last > impl->demo.getMessageCount())
+        last = impl->demo.getMessageCount();
+
+    std::exception_ptr error;
+    impl->failed = false;
+
+    //create every queue before any worker starts, a failing worker closes
+    //all of them (see fail())
+    for (size_t i = 0; i < impl->stages.size(); ++i) {
+        Stage* stage = impl->stages[i].get();
+        stage->error = std::exception_ptr();
+
+        if (stage->queueCapacity)
+            stage->queue.reset(new BoundedQueue<Item>(stage->queueCapacity));
+    }
+
+    //start threaded analyzers
+    for (size_t i = 0; i < impl->stages.size(); ++i) {
+        Stage* stage = impl->stages[i].get();
+
+        if (stage->queue)
+            stage->thread = std::thread(&DemoPipelineImpl::work, impl.get(), stage);
+    }
+
+    try {
+        for (size_t i = 0; i < impl->stages.size(); ++i)
+            if (!impl->stages[i]->queue)
+                impl->stages[i]->analyzer->begin();
+
+        SnapshotResolver resolver;
+
+        for (int id = first; id < last && !impl->failed; ++id) {
+            std::shared_ptr<Message> msg(impl->demo.takeMessage(id));
+            if (!msg)
+                continue;
+
+            std::shared_ptr<Snapshot> resolved = resolver.update(msg.get());
+
+            for (size_t i = 0; i < impl->stages.size(); ++i) {
+                Stage* stage = impl->stages[i].get();
+
+                if (stage->queue) {
+                    if (!stage->queue->push(Item(id, msg, resolved)))
+                        break; //closed by a failing analyzer
+                }
+                else
+                    stage->analyzer->onMessage(id, msg, resolved);
+            }
+        }
+
+        if (!impl->failed)
+            for (size_t i = 0; i < impl->stages.size(); ++i)
+                if (!impl->stages[i]->queue)
+                    impl->stages[i]->analyzer->end();
+    }
+    catch (...) {
+        error = std::current_exception();
+        impl->fail();
+    }
+
+    //flush and join threaded analyzers, queues are freed once no thread can close them
+    for (size_t i = 0; i < impl->stages.size(); ++i)
+        if (impl->stages[i]->queue)
+            impl->stages[i]->queue->close();
+
+    for (size_t i = 0; i < impl->stages.size(); ++i)
+        if (impl->stages[i]->thread.joinable())
+            impl->stages[i]->thread.join();
+
+    for (size_t i = 0; i < impl->stages.size(); ++i) {
+        Stage* stage = impl->stages[i].get();
+        stage->queue.reset();
+
+        if (!error && stage->error)
+            error = stage->error;
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+DEMO_NAMESPACE_END
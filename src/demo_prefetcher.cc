@@ -0,0 +1,217 @@
+#include <jka/demo_prefetcher.h>
+#include <jka/bounded_queue.h>
+
+#include <exception>
+#include <thread>
+
+DEMO_NAMESPACE_START
+
+class DemoPrefetcherImpl {
+public:
+    struct Input {
+        bool               end;
+        DemoBlock          block;
+        std::exception_ptr error; //read error, only with end
+
+        Input() : end(false) {}
+    };
+
+    struct Output {
+        bool                     end;
+        std::unique_ptr<Message> message;
+        std::exception_ptr       error;
+
+        Output() : end(false) {}
+    };
+
+    struct Worker {
+        BoundedQueue<Input>  input;
+        BoundedQueue<Output> output;
+        std::thread          thread;
+
+        explicit Worker(size_t capacity) : input(capacity), output(capacity) {}
+    };
+
+    DemoPrefetcherImpl() : stream(0), readAhead(256), decodeThreads(0),
+        started(false), finished(false), consumed(0) {}
+
+    void read();
+    void decode(Worker* worker);
+
+    std::string   filename;
+    std::ifstream file;
+    std::istream* stream;
+
+    int  readAhead;
+    int  decodeThreads;
+    bool started;
+    bool finished;
+
+    std::thread                          reader;
+    std::vector<std::unique_ptr<Worker>> workers;
+    size_t                               consumed;
+};
+
+void DemoPrefetcherImpl::read() {
+    size_t count = workers.size();
+    size_t index = 0;
+    std::exception_ptr error;
+
+    try {
+        while (true) {
+            Input in;
+            if (!readDemoBlock(*stream, in.block))
+                break;
+
+            if (!workers[index % count]->input.push(std::move(in)))
+                return; //stopped
+            ++index;
+        }
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+
+    //every worker gets end marker, the first one in order carries the error
+    for (size_t i = 0; i < count; ++i) {
+        Input in;
+        in.end = true;
+        if (i == 0)
+            in.error = error;
+
+        if (!workers[(index + i) % count]->input.push(std::move(in)))
+            return;
+    }
+}
+
+void DemoPrefetcherImpl::decode(Worker* worker) {
+    while (true) {
+        Input in;
+        if (!worker->input.pop(in))
+            return;
+
+        Output out;
+        out.end = in.end;
+        out.error = in.error;
+
+        if (!in.end) {
+            try {
+                std::unique_ptr<Message> msg(new Message());
+                if (decodeDemoBlock(*msg, in.block))
+                    out.message = std::move(msg);
+            }
+            catch (...) {
+                out.error = std::current_exception();
+            }
+        }
+
+        if (!worker->output.push(std::move(out)) || in.end)
+            return;
+    }
+}
+
+DemoPrefetcher::DemoPrefetcher(const std::string& filename) : impl(new DemoPrefetcherImpl()) {
+    impl->filename = filename;
+}
+
+DemoPrefetcher::DemoPrefetcher(std::istream& is) : impl(new DemoPrefetcherImpl()) {
+    impl->stream = &is;
+}
+
+DemoPrefetcher::~DemoPrefetcher() {
+    stop();
+}
+
+void DemoPrefetcher::setReadAhead(int blocks) {
+    impl->readAhead = std::max(1, blocks);
+}
+
+void DemoPrefetcher::setDecodeThreads(int count) {
+    impl->decodeThreads = std::max(0, count);
+}
+
+bool DemoPrefetcher::start() {
+    if (impl->started)
+        return true;
+
+    if (!impl->stream) {
+        impl->file.open(impl->filename, std::ios::binary);
+        if (!impl->file.is_open())
+            return false;
+        impl->stream = &impl->file;
+    }
+
+    int threads = impl->decodeThreads > 0 ? impl->decodeThreads
+        : (int)std::thread::hardware_concurrency();
+    threads = std::max(1, threads);
+
+    //read ahead is shared by all workers
+    size_t capacity = std::max(2, impl->readAhead / threads);
+
+    impl->finished = false;
+    impl->consumed = 0;
+
+    for (int i = 0; i < threads; ++i)
+        impl->workers.push_back(std::unique_ptr<DemoPrefetcherImpl::Worker>(
+            new DemoPrefetcherImpl::Worker(capacity)));
+
+    for (int i = 0; i < threads; ++i)
+        impl->workers[i]->thread = std::thread(&DemoPrefetcherImpl::decode,
+            impl.get(), impl->workers[i].get());
+
+    impl->reader = std::thread(&DemoPrefetcherImpl::read, impl.get());
+
+    return (impl->started = true);
+}
+
+std::unique_ptr<Message> DemoPrefetcher::next() {
+    if (impl->finished || !start())
+        return std::unique_ptr<Message>();
+
+    while (true) {
+        DemoPrefetcherImpl::Worker* worker = impl->workers[impl->consumed % impl->workers.size()].get();
+
+        DemoPrefetcherImpl::Output out;
+        if (!worker->output.pop(out))
+            return std::unique_ptr<Message>();
+        ++impl->consumed;
+
+        if (out.end)
+            impl->finished = true;
+
+        if (out.error)
+            std::rethrow_exception(out.error);
+
+        if (out.end)
+            return std::unique_ptr<Message>();
+
+        if (out.message)
+            return std::move(out.message);
+
+        //block was not loaded (ending message), go on
+    }
+}
+
+void DemoPrefetcher::stop() {
+    if (!impl->started)
+        return;
+
+    //wakes up threads waiting on queues, they exit on failed push/pop
+    for (size_t i = 0; i < impl->workers.size(); ++i) {
+        impl->workers[i]->input.close();
+        impl->workers[i]->output.close();
+    }
+
+    if (impl->reader.joinable())
+        impl->reader.join();
+
+    for (size_t i = 0; i < impl->workers.size(); ++i)
+        if (impl->workers[i]->thread.joinable())
+            impl->workers[i]->thread.join();
+
+    impl->workers.clear();
+    impl->started = false;
+    impl->finished = true;
+}
+
+DEMO_NAMESPACE_END
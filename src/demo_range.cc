@@ -0,0 +1,114 @@
+#include <jka/demo_range.h>
+#include <jka/demo.h>
+#include <jka/snapshot_resolver.h>
+
+DEMO_NAMESPACE_START
+
+/*
+
+SnapshotRange Implementation
+
+*/
+
+SnapshotRange::iterator::iterator(Demo* demo, int first, int last)
+    : demo(demo), id(std::max(0, first)), resolver(new SnapshotResolver()) {
+
+    int count = demo->getMessageCount();
+    this->last = (last < 0 || last > count) ? count : last;
+
+    advance();
+}
+
+void SnapshotRange::iterator::advance() {
+    for (; id < last; ++id) {
+        //messages loaded (or edited) by the caller are left as they are
+        bool loadedHere = !demo->isMessageLoaded(id);
+        std::shared_ptr<Snapshot> resolved = resolver->update(demo->getMessage(id));
+        if (loadedHere)
+            demo->unloadMessage(id);
+
+        if (resolved) {
+            current = resolved;
+            return;
+        }
+    }
+
+    //reached end
+    demo = 0;
+    current.reset();
+    resolver.reset();
+}
+
+SnapshotRange::iterator& SnapshotRange::iterator::operator++() {
+    if (demo) {
+        ++id;
+        advance();
+    }
+    return *this;
+}
+
+bool SnapshotRange::iterator::operator==(const iterator& other) const {
+    if (!demo || !other.demo)
+        return demo == other.demo;
+
+    return id == other.id;
+}
+
+/*
+
+ServerCommandRange Implementation
+
+*/
+
+ServerCommandRange::iterator::iterator(Demo* demo, int first, int last)
+    : demo(demo), id(std::max(0, first)), instruction(0), current(0), loadedHere(false) {
+
+    int count = demo->getMessageCount();
+    this->last = (last < 0 || last > count) ? count : last;
+
+    advance();
+}
+
+void ServerCommandRange::iterator::advance() {
+    while (id < last) {
+        if (instruction == 0) //entering this message
+            loadedHere = !demo->isMessageLoaded(id);
+
+        Message* msg = demo->getMessage(id);
+
+        if (msg) {
+            for (; instruction < msg->getInstructionsCount(); ++instruction) {
+                current = msg->getInstruction(instruction)->getServerCommand();
+                if (current)
+                    return;
+            }
+        }
+
+        //done with this message, unloaded only if this iterator loaded it
+        if (loadedHere)
+            demo->unloadMessage(id);
+        ++id;
+        instruction = 0;
+    }
+
+    //reached end
+    demo = 0;
+    current = 0;
+}
+
+ServerCommandRange::iterator& ServerCommandRange::iterator::operator++() {
+    if (demo) {
+        ++instruction;
+        advance();
+    }
+    return *this;
+}
+
+bool ServerCommandRange::iterator::operator==(const iterator& other) const {
+    if (!demo || !other.demo)
+        return demo == other.demo;
+
+    return id == other.id && instruction == other.instruction;
+}
+
+DEMO_NAMESPACE_END
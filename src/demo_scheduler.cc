@@ -0,0 +1,148 @@
+#include <jka/demo_scheduler.h>
+#include <jka/defs.h>
+#include <jka/snapshot_resolver.h>
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+DEMO_NAMESPACE_START
+
+DemoScheduler::DemoScheduler(const std::string& filename)
+    : filename(filename), threadCount(0), minSegmentLength(256), splitted(false) {
+}
+
+bool DemoScheduler::split() {
+    segments.clear();
+    splitted = false;
+
+    Demo demo;
+    if (!demo.open(filename, false))
+        return false;
+
+    int count = demo.getMessageCount();
+    std::vector<MessagePeek> peeks(count);
+
+    for (int i = 0; i < count; ++i)
+        demo.peekMessage(i, peeks[i]);
+
+    //index of the oldest message each message depends on
+    std::vector<int> reference(count);
+    for (int i = 0; i < count; ++i) {
+        reference[i] = i;
+
+        int seq = peeks[i].deltaSequence();
+        if (seq < 0)
+            continue;
+
+        //delta base is at most PACKET_BACKUP messages behind
+        for (int j = i - 1; j >= 0 && j >= i - PACKET_BACKUP; --j) {
+            if (peeks[j].sequenceNumber == seq) {
+                reference[i] = j;
+                break;
+            }
+        }
+    }
+
+    //keyframe i is a valid split point if nothing after it refers before it
+    std::vector<bool> splitPoint(count, false);
+    int oldest = count;
+    for (int i = count - 1; i >= 0; --i) {
+        oldest = std::min(oldest, reference[i]);
+        splitPoint[i] = peeks[i].isKeyframe() && (oldest >= i);
+    }
+
+    int first = 0;
+    for (int i = 1; i < count; ++i) {
+        if (splitPoint[i] && (i - first >= minSegmentLength)) {
+            segments.push_back(DemoSegment(first, i));
+            first = i;
+        }
+    }
+
+    if (first < count)
+        segments.push_back(DemoSegment(first, count));
+
+    splitted = true;
+    return true;
+}
+
+void DemoScheduler::runSegment(Demo& demo, const DemoSegment& segment,
+    SegmentAnalyzer& analyzer) const {
+
+    SnapshotResolver resolver;
+
+    analyzer.begin(segment);
+
+    for (int id = segment.first; id < segment.last; ++id) {
+        Message* msg = demo.getMessage(id);
+        if (!msg)
+            continue;
+
+        std::shared_ptr<Snapshot> resolved = resolver.update(msg);
+
+        analyzer.onMessage(id, msg, resolved.get());
+        demo.unloadMessage(id);
+    }
+
+    analyzer.end();
+}
+
+std::vector<std::unique_ptr<SegmentAnalyzer>> DemoScheduler::run(const AnalyzerFactory& factory) {
+    std::vector<std::unique_ptr<SegmentAnalyzer>> results;
+
+    if (!splitted && !split())
+        throw DemoException("cannot open demo");
+
+    int count = (int)segments.size();
+    results.resize(count);
+
+    int threads = threadCount > 0 ? threadCount : (int)std::thread::hardware_concurrency();
+    threads = std::max(1, std::min(threads, count));
+
+    std::atomic<int> next(0);
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    auto worker = [&]() {
+        Demo demo;
+        if (!demo.open(filename, false)) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error)
+                error = std::make_exception_ptr(DemoException("cannot open demo"));
+            return;
+        }
+
+        int index;
+        while ((index = next.fetch_add(1)) < count) {
+            try {
+                std::unique_ptr<SegmentAnalyzer> analyzer = factory();
+                runSegment(demo, segments[index], *analyzer);
+                results[index] = std::move(analyzer);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error)
+                    error = std::current_exception();
+                next = count; //stop other workers early
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threads; ++i)
+        pool.push_back(std::thread(worker));
+
+    worker(); //calling thread works too
+
+    for (std::vector<std::thread>::iterator it = pool.begin(); it != pool.end(); ++it)
+        it->join();
+
+    if (error)
+        std::rethrow_exception(error);
+
+    return results;
+}
+
+DEMO_NAMESPACE_END
@@ -0,0 +1,156 @@
+#include <jka/demo_source.h>
+#include <jka/compressed_source.h>
+
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define JKA_HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+DEMO_NAMESPACE_START
+
+/*
+
+FileSource Implementation
+
+*/
+
+FileSource::FileSource(const std::string& filename)
+    : file(filename, std::ios::binary), position(0), length(0) {
+
+    if (!file.is_open())
+        return;
+
+    file.seekg(0, std::ios_base::end);
+    length = (size_t)file.tellg();
+    file.seekg(0, std::ios_base::beg);
+}
+
+size_t FileSource::read(void* dest, size_t count) {
+    file.read((char*)dest, count);
+
+    size_t got = (size_t)file.gcount();
+    position += got;
+
+    if (got < count)
+        file.clear(); //hit the end, keep stream usable for next seek
+
+    return got;
+}
+
+bool FileSource::seek(size_t offset) {
+    if (offset > length)
+        return false;
+
+    file.seekg(offset, std::ios_base::beg);
+    position = offset;
+    return !file.fail();
+}
+
+/*
+
+MemorySource Implementation
+
+*/
+
+MemorySource::MemorySource(const void* data, size_t length)
+    : data((const byte*)data), length(length), position(0) {
+}
+
+MemorySource::MemorySource(std::vector<byte> bytes)
+    : data(0), length(bytes.size()), position(0), owned(std::move(bytes)) {
+    data = owned.data();
+}
+
+size_t MemorySource::read(void* dest, size_t count) {
+    size_t got = std::min(count, length - position);
+
+    memcpy(dest, data + position, got);
+    position += got;
+
+    return got;
+}
+
+bool MemorySource::seek(size_t offset) {
+    if (offset > length)
+        return false;
+
+    position = offset;
+    return true;
+}
+
+const byte* MemorySource::view(size_t offset, size_t count) const {
+    if (offset > length || count > length - offset)
+        return 0;
+
+    return data + offset;
+}
+
+/*
+
+MmapSource Implementation
+
+*/
+
+MmapSource::MmapSource(const std::string& filename) : mapping(0) {
+#ifdef JKA_HAVE_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        void* address = mmap(0, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (address != MAP_FAILED) {
+            madvise(address, (size_t)info.st_size, MADV_SEQUENTIAL);
+            mapping = address;
+            data = (const byte*)address;
+            length = (size_t)info.st_size;
+        }
+    }
+
+    ::close(fd); //mapping stays valid
+#else
+    (void)filename;
+#endif
+}
+
+MmapSource::~MmapSource() {
+#ifdef JKA_HAVE_MMAP
+    if (mapping)
+        munmap(mapping, length);
+#endif
+}
+
+std::unique_ptr<DemoSource> openDemoSource(const std::string& filename) {
+    std::unique_ptr<DemoSource> source;
+
+#ifdef JKA_HAVE_MMAP
+    std::unique_ptr<MmapSource> mapped(new MmapSource(filename));
+    if (mapped->isOpen())
+        source = std::move(mapped);
+#endif
+
+    if (!source) {
+        //no mmap support, or empty file which cannot be mapped
+        std::unique_ptr<FileSource> file(new FileSource(filename));
+        if (!file->isOpen())
+            return std::unique_ptr<DemoSource>();
+
+        source = std::move(file);
+    }
+
+    //.dm_26.gz, .dm_26.zst are decompressed transparently
+    CompressedSource::Format format = CompressedSource::detect(*source);
+    if (format != CompressedSource::FORMAT_NONE)
+        source.reset(new CompressedSource(std::move(source), format));
+
+    return source;
+}
+
+DEMO_NAMESPACE_END
@@ -0,0 +1,42 @@
+#include <jka/demo_stream_reader.h>
+
+DEMO_NAMESPACE_START
+
+DemoStreamReader::DemoStreamReader(std::istream& is) : is(is), count(0), ended(false) {
+}
+
+Message* DemoStreamReader::next() {
+    current.reset();
+
+    while (!ended) {
+        if (!readDemoBlock(is, block)) {
+            ended = true;
+            break;
+        }
+
+        std::unique_ptr<Message> msg(new Message());
+        if (!decodeDemoBlock(*msg, block))
+            continue;
+
+        current = resolver.update(msg.get());
+
+        //oldest message of the window is dropped
+        std::unique_ptr<Message>& slot = window[count % PACKET_BACKUP];
+        slot = std::move(msg);
+        ++count;
+
+        return slot.get();
+    }
+
+    return 0;
+}
+
+Message* DemoStreamReader::findMessage(int sequenceNumber) const {
+    for (int i = 0; i < PACKET_BACKUP; ++i)
+        if (window[i] && window[i]->getSeqNumber() == sequenceNumber)
+            return window[i].get();
+
+    return 0;
+}
+
+DEMO_NAMESPACE_END
@@ -0,0 +1,46 @@
+#include <jka/demo_writer.h>
+
+#include <cstring>
+#include <sstream>
+
+DEMO_NAMESPACE_START
+
+DemoWriter::DemoWriter(std::ostream& os) : os(os), sequenceShift(0), count(0) {
+}
+
+void DemoWriter::writeBlock(const DemoBlock& block) {
+    int sequenceNumber = block.sequenceNumber + sequenceShift;
+
+    os.write((char*)&sequenceNumber, sizeof(sequenceNumber));
+    os.write((char*)&block.length, sizeof(block.length));
+    os.write((char*)block.data.data(), block.length);
+
+    ++count;
+}
+
+void DemoWriter::writeMessage(const Message& message) {
+    if (!sequenceShift) {
+        message.save(os);
+        ++count;
+        return;
+    }
+
+    //encode aside and patch header, message itself is left untouched
+    std::ostringstream encoded(std::ios::binary);
+    message.save(encoded);
+
+    std::string data = encoded.str();
+    int sequenceNumber = message.getSeqNumber() + sequenceShift;
+    memcpy(&data[0], &sequenceNumber, sizeof(sequenceNumber));
+
+    os.write(data.data(), data.size());
+    ++count;
+}
+
+void DemoWriter::writeEnd() {
+    int end = -1;
+    os.write((char*)&end, 4);
+    os.write((char*)&end, 4);
+}
+
+DEMO_NAMESPACE_END
@@ -0,0 +1,236 @@
+#include <jka/event_extractor.h>
+#include <jka/demo_block.h>
+
+DEMO_NAMESPACE_START
+
+namespace {
+
+//tracked fields, in DeltaResolver order
+enum EntityField {
+    E_TYPE = 0,
+    E_EVENT,
+    E_EVENT_PARM,
+    E_OTHER,
+    E_OTHER2,
+    E_FLAGS
+};
+
+enum PlayerField {
+    P_CLIENTNUM = 0,
+    P_EVENT_SEQUENCE,
+    P_EVENTS,           //MAX_PS_EVENTS fields
+    P_EVENT_PARMS = P_EVENTS + MAX_PS_EVENTS,
+    P_EXTERNAL_EVENT = P_EVENT_PARMS + MAX_PS_EVENTS,
+    P_EXTERNAL_PARM
+};
+
+const std::vector<std::string> ENTITY_FIELDS = {
+    "eType", "event", "eventParm", "otherEntityNum", "otherEntityNum2", "eFlags"
+};
+
+const std::vector<std::string> PLAYER_FIELDS = {
+    "clientNum", "eventSequence", "events[0]", "events[1]",
+    "eventParms[0]", "eventParms[1]", "externalEvent", "externalEventParm"
+};
+
+int entityOrNone(int number) {
+    return (number < 0 || number >= ENTITYNUM_WORLD) ? -1 : number;
+}
+
+}
+
+bool toObituary(const GameEvent& event, Obituary& obituary) {
+    if (event.event != EV_OBITUARY)
+        return false;
+
+    obituary.victim = event.otherEntityNum;
+    obituary.killer = entityOrNone(event.otherEntityNum2);
+    obituary.meansOfDeath = event.eventParm;
+    return true;
+}
+
+bool toItemPickup(const GameEvent& event, ItemPickup& pickup) {
+    if (event.event != EV_ITEM_PICKUP && event.event != EV_GLOBAL_ITEM_PICKUP)
+        return false;
+
+    pickup.global = (event.event == EV_GLOBAL_ITEM_PICKUP);
+    pickup.clientNum = (pickup.global || event.entityNum >= MAX_CLIENTS) ? -1 : event.entityNum;
+    pickup.item = event.eventParm;
+    return true;
+}
+
+bool toHit(const GameEvent& event, Hit& hit) {
+    if (event.event == EV_SABER_HIT) {
+        hit.victim = entityOrNone(event.otherEntityNum);
+        hit.attacker = entityOrNone(event.otherEntityNum2);
+        hit.health = -1;
+        hit.saber = true;
+        return true;
+    }
+
+    if (event.event == EV_PAIN) {
+        hit.victim = event.entityNum;
+        hit.attacker = -1;
+        hit.health = event.eventParm;
+        hit.saber = false;
+        return true;
+    }
+
+    return false;
+}
+
+/*
+
+EventExtractor Implementation
+
+*/
+
+EventExtractor::EventExtractor(Listener listener)
+    : listener(listener), resolver(ENTITY_FIELDS, PLAYER_FIELDS) {
+    reset();
+}
+
+void EventExtractor::reset() {
+    EntityHistory none;
+    none.previousEvent = 0;
+    none.lastSeen = 0;
+    none.lastFrame = -1;
+
+    resolver.reset();
+    entities.assign(MAX_GENTITIES, none);
+    previousPlayer.clear();
+    frameCount = 0;
+}
+
+void EventExtractor::update(int messageId, Message* message) {
+    for (int i = 0; i < message->getInstructionsCount(); ++i) {
+        if (message->getInstruction(i)->getType() == INSTR_GAMESTATE) {
+            reset(); //resolver loads baselines below
+            break;
+        }
+    }
+
+    const DeltaResolver::Frame* frame = resolver.update(message);
+    if (!frame)
+        return;
+
+    checkEntities(messageId, *frame);
+    checkPlayerState(messageId, *frame);
+    ++frameCount;
+}
+
+bool EventExtractor::run(const Demo& demo) {
+    reset();
+
+    DemoBlock block;
+
+    for (int i = 0; i < demo.getMessageCount(); ++i) {
+        Message msg;
+        if (!demo.readRawMessage(i, block) || !decodeDemoBlock(msg, block))
+            return false;
+
+        update(i, &msg);
+    }
+
+    return true;
+}
+
+void EventExtractor::checkEntities(int messageId, const DeltaResolver::Frame& frame) {
+    GameEvent event;
+    event.messageId = messageId;
+    event.serverTime = frame.serverTime;
+    event.playerState = false;
+
+    for (int i = 0; i < frame.getEntitiesCount(); ++i) {
+        int number = frame.entities[i];
+        EntityHistory& history = entities[number];
+
+        //entity was not in previous frame: CG_ResetEntity
+        if (history.lastFrame != frameCount - 1 && history.lastSeen < frame.serverTime - EVENT_VALID_MSEC)
+            history.previousEvent = 0;
+
+        history.lastSeen = frame.serverTime;
+        history.lastFrame = frameCount;
+
+        int type = resolver.get(frame, i, E_TYPE);
+        int entityNum = number;
+
+        if (type >= ET_EVENTS) {
+            if (history.previousEvent)
+                continue; //already fired
+
+            //predictable event of another player: CG_CheckEvents uses the client
+            if (resolver.get(frame, i, E_FLAGS) & EF_PLAYER_EVENT)
+                entityNum = resolver.get(frame, i, E_OTHER);
+
+            history.previousEvent = 1;
+            event.event = type - ET_EVENTS;
+            event.temp = true;
+        }
+        else {
+            int value = resolver.get(frame, i, E_EVENT);
+            if (value == history.previousEvent)
+                continue;
+
+            history.previousEvent = value;
+            event.event = value & ~EV_EVENT_BITS;
+            event.temp = false;
+        }
+
+        event.entityNum = entityNum;
+        event.eventParm = resolver.get(frame, i, E_EVENT_PARM);
+        event.otherEntityNum = resolver.get(frame, i, E_OTHER);
+        event.otherEntityNum2 = resolver.get(frame, i, E_OTHER2);
+        fire(event);
+    }
+}
+
+void EventExtractor::checkPlayerState(int messageId, const DeltaResolver::Frame& frame) {
+    const std::vector<int>& ps = frame.player;
+
+    if (previousPlayer.empty()) { //first frame, nothing to compare to
+        previousPlayer = ps;
+        return;
+    }
+
+    const std::vector<int>& ops = previousPlayer;
+
+    GameEvent event;
+    event.messageId = messageId;
+    event.serverTime = frame.serverTime;
+    event.entityNum = ps[P_CLIENTNUM];
+    event.otherEntityNum = 0;
+    event.otherEntityNum2 = 0;
+    event.temp = false;
+    event.playerState = true;
+
+    if (ps[P_EXTERNAL_EVENT] && ps[P_EXTERNAL_EVENT] != ops[P_EXTERNAL_EVENT]) {
+        event.event = ps[P_EXTERNAL_EVENT] & ~EV_EVENT_BITS;
+        event.eventParm = ps[P_EXTERNAL_PARM];
+        fire(event);
+    }
+
+    //events the previous frame did not have yet
+    int sequence = ps[P_EVENT_SEQUENCE];
+    int previousSequence = ops[P_EVENT_SEQUENCE];
+
+    for (int i = sequence - MAX_PS_EVENTS; i < sequence; ++i) {
+        int slot = i & (MAX_PS_EVENTS - 1);
+
+        if (i >= previousSequence
+            || (i > previousSequence - MAX_PS_EVENTS && ps[P_EVENTS + slot] != ops[P_EVENTS + slot])) {
+            event.event = ps[P_EVENTS + slot] & ~EV_EVENT_BITS;
+            event.eventParm = ps[P_EVENT_PARMS + slot];
+            fire(event);
+        }
+    }
+
+    previousPlayer = ps;
+}
+
+void EventExtractor::fire(const GameEvent& event) {
+    if (event.event && listener) //EV_NONE
+        listener(event);
+}
+
+DEMO_NAMESPACE_END
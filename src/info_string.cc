@@ -0,0 +1,100 @@
+#include <jka/info_string.h>
+
+#include <cctype>
+
+DEMO_NAMESPACE_START
+
+namespace {
+
+bool equalsNoCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size())
+        return false;
+
+    for (size_t i = 0; i < a.size(); ++i)
+        if (tolower((unsigned char)a[i]) != tolower((unsigned char)b[i]))
+            return false;
+
+    return true;
+}
+
+}
+
+unsigned InfoStringView::hash(std::string_view key) {
+    unsigned h = 2166136261u; //FNV-1a
+
+    for (size_t i = 0; i < key.size(); ++i) {
+        h ^= (unsigned)tolower((unsigned char)key[i]);
+        h *= 16777619u;
+    }
+
+    return h;
+}
+
+void InfoStringView::parse(std::string_view info) {
+    entries.clear();
+
+    size_t pos = (!info.empty() && info[0] == '\\') ? 1 : 0;
+
+    while (pos < info.size()) {
+        size_t keyEnd = info.find('\\', pos);
+        if (keyEnd == std::string_view::npos)
+            break; //key without value
+
+        size_t valueEnd = info.find('\\', keyEnd + 1);
+        if (valueEnd == std::string_view::npos)
+            valueEnd = info.size();
+
+        Entry entry;
+        entry.key = info.substr(pos, keyEnd - pos);
+        entry.value = info.substr(keyEnd + 1, valueEnd - keyEnd - 1);
+        entries.push_back(entry);
+
+        pos = valueEnd + 1;
+    }
+
+    //table at most half full
+    size_t capacity = 8;
+    while (capacity < entries.size() * 2)
+        capacity *= 2;
+
+    slots.assign(capacity, 0);
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        size_t slot = hash(entries[i].key) & (capacity - 1);
+
+        while (slots[slot]) {
+            //first occurrence wins, as in Info_ValueForKey
+            if (equalsNoCase(entries[slots[slot] - 1].key, entries[i].key))
+                break;
+            slot = (slot + 1) & (capacity - 1);
+        }
+
+        if (!slots[slot])
+            slots[slot] = (int)i + 1;
+    }
+}
+
+int InfoStringView::find(std::string_view key) const {
+    if (slots.empty())
+        return -1;
+
+    size_t mask = slots.size() - 1;
+    size_t slot = hash(key) & mask;
+
+    while (slots[slot]) {
+        int index = slots[slot] - 1;
+        if (equalsNoCase(entries[index].key, key))
+            return index;
+
+        slot = (slot + 1) & mask;
+    }
+
+    return -1;
+}
+
+std::string_view InfoStringView::value(std::string_view key) const {
+    int index = find(key);
+    return index >= 0 ? entries[index].value : std::string_view();
+}
+
+DEMO_NAMESPACE_END
@@ -1,4 +1,5 @@
 #include <jka/instruction.h>
+#include <jka/message.h>
 
 DEMO_NAMESPACE_START
 
@@ -58,19 +59,46 @@ ServerCommand Implementation
 
 */
 
+ServerCommand::ServerCommand(const ServerCommand& other)
+    : Instruction(other), sequenceNumber(other.sequenceNumber),
+      edited(other.getCommand()), isEdited(true) {
+}
+
+//copy owns its text, source message may go away
+ServerCommand& ServerCommand::operator=(const ServerCommand& other) {
+    if (this != &other) {
+        Instruction::operator=(other);
+        sequenceNumber = other.sequenceNumber;
+        edited = std::string(other.getCommand());
+        command = std::string_view();
+        isEdited = true;
+    }
+    return *this;
+}
+
 void ServerCommand::Save() const {
     Message::buffer.writeBits(svc_serverCommand, SIZE_8BITS);
     Message::buffer.writeBits(sequenceNumber, SIZE_32BITS);
-    Message::buffer.writeString(command, false);
+    Message::buffer.writeString(getCommand(), false);
 }
 
 void ServerCommand::Load() {
     sequenceNumber = Message::buffer.readBits(SIZE_32BITS);
-    command = Message::buffer.readString(true);
+
+    if (Message::strings) { //decoded as part of a message, text kept in its arena
+        command = Message::buffer.readStringView(*Message::strings, true);
+        edited.clear();
+        isEdited = false;
+    }
+    else { //standalone, owns its text
+        command = std::string_view();
+        edited = Message::buffer.readString(true);
+        isEdited = true;
+    }
 }
 
 void ServerCommand::report(std::ostream& os) const {
-    std::string s = command;
+    std::string s(getCommand());
 
     for (std::string::iterator it = s.begin(); it != s.end(); ++it)
         if (*it == '\n')
@@ -86,12 +114,39 @@ Snapshot* Snapshot::clone() {
     Snapshot* snap = new Snapshot(*this);
 
     snap->playerState = playerState->clone();
-    snap->vehicleState = 0; //make clone for vehicle states too!
+    snap->vehicleState = vehicleState ? vehicleState->clone() : 0;
     snap->entities = this->entities;
 
     return snap;
 }
 
+bool Snapshot::isModified() const noexcept {
+    if (modified)
+        return true;
+
+    if ((playerState && playerState->isModified()) || (vehicleState && vehicleState->isModified()))
+        return true;
+
+    for (entitymap_cit it = entities.begin(); it != entities.end(); ++it)
+        if (it->second.isModified())
+            return true;
+
+    return false;
+}
+
+void Snapshot::setModified(bool value) noexcept {
+    modified = value;
+
+    if (playerState)
+        playerState->setModified(value);
+
+    if (vehicleState)
+        vehicleState->setModified(value);
+
+    for (entitymap_it it = entities.begin(); it != entities.end(); ++it)
+        it->second.setModified(value);
+}
+
 Snapshot::~Snapshot() {
     if (playerState)
         delete playerState;
@@ -199,6 +254,7 @@ void Snapshot::report(std::ostream& os) const {
 }
 
 void Snapshot::delta(Snapshot* snap) {
+    modified = true;
     assert(snap);
 
     if (!playerState)
@@ -235,6 +291,7 @@ void Snapshot::delta(Snapshot* snap) {
 }
 
 void Snapshot::applyOn(Snapshot* snap) {
+    modified = true;
     assert(snap);
 
     if (!playerState)
@@ -278,6 +335,7 @@ void Snapshot::applyOn(Snapshot* snap) {
 }
 
 void Snapshot::makeInit() {
+    modified = true;
     playerState->removeNull();
 
     //get rid of entities ordered to remove
@@ -295,6 +353,7 @@ void Snapshot::makeInit() {
 }
 
 void Snapshot::removeNotChanged() {
+    modified = true;
 
     for (entitymap_it it = entities.begin(); it != entities.end();) {
         if (it->second.noChanged() && !it->second.isRemoved()) {
@@ -372,7 +431,44 @@ void Gamestate::Save() const {
     }
 }
 
+Gamestate::Gamestate(const Gamestate& other) : Instruction(other) {
+    *this = other;
+}
+
+//configstrings are copied to own arena, source message may go away
+Gamestate& Gamestate::operator=(const Gamestate& other) {
+    if (this == &other)
+        return *this;
+
+    Instruction::operator=(other);
+    commandSequence = other.commandSequence;
+    clientNumber = other.clientNumber;
+    checksumFeed = other.checksumFeed;
+    magicStuff = other.magicStuff;
+    magicSeed = other.magicSeed;
+    magicData = other.magicData;
+    baseEntities = other.baseEntities;
+
+    std::shared_ptr<StringArena> arena = std::make_shared<StringArena>();
+    configStrings.clear();
+    for (stringmap_cit it = other.configStrings.begin(); it != other.configStrings.end(); ++it)
+        configStrings[it->first] = arena->store(it->second);
+
+    edits = arena;
+    infoCache.clear();
+    return *this;
+}
+
 void Gamestate::Load() {
+    //outside of a message, strings go to own arena
+    StringArena* arena = Message::strings;
+    if (!arena) {
+        if (!edits)
+            edits = std::make_shared<StringArena>();
+        arena = edits.get();
+    }
+    infoCache.clear();
+
     //server command sequence
     commandSequence = Message::buffer.readBits(SIZE_32BITS);
 
@@ -389,7 +485,7 @@ void Gamestate::Load() {
             if (i < 0 || i >= MAX_CONFIGSTRINGS)
                 throw DemoException("configstring id out of range");
 
-            configStrings[i] = Message::buffer.readString(true);
+            configStrings[i] = Message::buffer.readStringView(*arena, true);
         }
         else if (cmd == svc_baseline) {
             int newnum = Message::buffer.readBits(SIZE_ENTITY_BITS);
@@ -465,11 +561,24 @@ void Gamestate::report(std::ostream& os) const {
     }
 }
 
-std::string Gamestate::getConfigstring(int id) {
+std::string_view Gamestate::getConfigstring(int id) {
     if (id < 0 || id >= MAX_CONFIGSTRINGS)
         throw DemoException("configstring id out of range");
 
-    return configStrings[id];
+    stringmap_cit it = configStrings.find(id);
+    return it != configStrings.end() ? it->second : std::string_view();
+}
+
+const InfoStringView& Gamestate::getConfigstringInfo(int id) const {
+    std::map<int, InfoStringView>::iterator it = infoCache.find(id);
+
+    if (it == infoCache.end()) {
+        stringmap_cit cs = configStrings.find(id);
+        it = infoCache.insert(std::make_pair(id, InfoStringView(
+            cs != configStrings.end() ? cs->second : std::string_view()))).first;
+    }
+
+    return it->second;
 }
 
 void Gamestate::removeConfigstring(int id) {
@@ -477,6 +586,8 @@ void Gamestate::removeConfigstring(int id) {
 
     if (it != configStrings.end()) {
         configStrings.erase(it);
+        infoCache.erase(id);
+        modified = true;
     }
 }
 
@@ -502,22 +613,31 @@ void Gamestate::getMagicData(unsigned id, int* byte1, int* byte2, int* int1, int
     if (int2) *int2 = magicData[id].int2;
 }
 
-void Gamestate::setConfigstring(int id, const std::string& s) {
+void Gamestate::setConfigstring(int id, std::string_view s) {
+    modified = true;
     if (id < 0 || id >= MAX_CONFIGSTRINGS)
         throw DemoException("configstring id out of range");
 
-    configStrings[id] = s;
+    //older values stay in arena, views handed out before remain valid
+    if (!edits)
+        edits = std::make_shared<StringArena>();
+
+    configStrings[id] = edits->store(s);
+    infoCache.erase(id);
 }
 
 void Gamestate::setMagicStuff(const std::string& s) {
+    modified = true;
     magicStuff = s;
 }
 
 void Gamestate::setMagicSeed(int seed) {
+    modified = true;
     magicSeed = seed;
 }
 
 void Gamestate::setMagicData(unsigned id, int byte1, int byte2, int int1, int int2) {
+    modified = true;
     if (magicData.size() <= id) {
         magicData.resize(id + 1);
     }
@@ -531,16 +651,13 @@ void Gamestate::setMagicData(unsigned id, int byte1, int byte2, int int1, int in
 void Gamestate::update(const ServerCommand* servercommand) {
     assert(servercommand);
 
-    const std::string command = servercommand->getCommand();
-    if (command.find("cs ") == 0) {
-        int i;
-
-        int start = (int)command.find_first_of(' ', 3);
-        std::stringstream stream(command.substr(3, start - 3));
-        stream >> i;
+    std::string_view command = servercommand->getCommand();
+    if (command.compare(0, 3, "cs ") == 0) {
+        size_t start = command.find_first_of(' ', 3);
+        int i = atoi(std::string(command.substr(3, start - 3)).c_str());
 
-        start = (int)command.find_first_of('"', start);
-        int end = (int)command.find_first_of('"', start + 1);
+        start = command.find_first_of('"', start);
+        size_t end = command.find_first_of('"', start + 1);
 
         setConfigstring(i, command.substr(start + 1, end - start - 1));
     }
@@ -0,0 +1,324 @@
+#include <jka/json_writer.h>
+#include <jka/state.h>
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+DEMO_NAMESPACE_START
+
+namespace {
+
+const char HEX[] = "0123456789abcdef";
+
+void writeAttributes(JsonWriter& json, const State& state) {
+    int count;
+    const Field* fields = state.getNetfields(count);
+
+    for (int i = 0; i < count; ++i) {
+        if (!state.isAttributeSet(i))
+            continue;
+
+        json.key(fields[i]._name);
+        if (fields[i].type == FIELD_FLOAT)
+            json.value(state.getAttributeFloat(i));
+        else
+            json.value(state.getAttributeInt(i));
+    }
+}
+
+void writeArray(JsonWriter& json, const char* name, const std::map<int, int>& values) {
+    if (values.empty())
+        return;
+
+    json.key(name);
+    json.beginObject();
+    for (const auto& [id, value] : values) {
+        json.key(id);
+        json.value(value);
+    }
+    json.endObject();
+}
+
+void writePlayer(JsonWriter& json, const PlayerState& ps) {
+    json.beginObject();
+    writeAttributes(json, ps);
+    writeArray(json, "stats", ps.getStats());
+    writeArray(json, "persistant", ps.getPersistant());
+    writeArray(json, "ammo", ps.getAmmo());
+    writeArray(json, "powerups", ps.getPowerups());
+    json.endObject();
+}
+
+void writeEntities(JsonWriter& json, const std::map<int, EntityState>& entities) {
+    json.beginObject();
+    for (const auto& [number, entity] : entities) {
+        json.key(number);
+        json.beginObject();
+        if (entity.isRemoved()) {
+            json.key("removed");
+            json.value(true);
+        }
+        else {
+            writeAttributes(json, entity);
+        }
+        json.endObject();
+    }
+    json.endObject();
+}
+
+void writeInstruction(JsonWriter& json, Instruction* instr) {
+    json.beginObject();
+    json.key("type");
+
+    if (Gamestate* gamestate = instr->getGamestate()) {
+        json.value("gamestate");
+        json.key("commandSequence");
+        json.value(gamestate->getCommandSequence());
+        json.key("clientNum");
+        json.value(gamestate->getClientNumber());
+        json.key("checksumFeed");
+        json.value(gamestate->getChecksumFeed());
+
+        json.key("configstrings");
+        json.beginObject();
+        for (const auto& [index, value] : gamestate->getConfigStrings()) {
+            json.key(index);
+            json.value(value);
+        }
+        json.endObject();
+
+        json.key("baselines");
+        writeEntities(json, gamestate->getBaseEntities());
+    }
+    else if (ServerCommand* command = instr->getServerCommand()) {
+        json.value("server_command");
+        json.key("sequence");
+        json.value(command->getSequenceNumber());
+        json.key("command");
+        json.value(command->getCommand());
+    }
+    else if (Snapshot* snapshot = instr->getSnapshot()) {
+        json.value("snapshot");
+        json.key("serverTime");
+        json.value(snapshot->getServertime());
+        json.key("deltaNum");
+        json.value(snapshot->getDeltanum());
+        json.key("snapFlags");
+        json.value(snapshot->getSnapflags());
+
+        if (const PlayerState* ps = snapshot->getPlayerstate()) {
+            json.key("player");
+            writePlayer(json, *ps);
+        }
+        if (const PlayerState* vehicle = snapshot->getVehiclestate()) {
+            json.key("vehicle");
+            writePlayer(json, *vehicle);
+        }
+
+        json.key("entities");
+        writeEntities(json, snapshot->getEntities());
+    }
+    else if (MapChange* mapChange = instr->getMapChange()) {
+        json.value("map_change");
+        json.key("map");
+        json.value(mapChange->getMapChange());
+    }
+    else {
+        json.value("unknown");
+    }
+
+    json.endObject();
+}
+
+}
+
+/*
+
+JsonWriter Implementation
+
+*/
+
+JsonWriter::JsonWriter(std::ostream& os, size_t bufferSize)
+    : os(os), buffer(bufferSize < 64 ? 64 : bufferSize), used(0), needComma(false) {
+}
+
+JsonWriter::~JsonWriter() {
+    flush();
+}
+
+bool JsonWriter::flush() {
+    if (used) {
+        os.write(buffer.data(), used);
+        used = 0;
+    }
+    return os.good();
+}
+
+void JsonWriter::put(char c) {
+    if (used == buffer.size())
+        flush();
+    buffer[used++] = c;
+}
+
+void JsonWriter::put(std::string_view s) {
+    if (s.size() > buffer.size() - used) {
+        flush();
+        if (s.size() > buffer.size()) { //bigger than buffer, no copy
+            os.write(s.data(), s.size());
+            return;
+        }
+    }
+
+    memcpy(buffer.data() + used, s.data(), s.size());
+    used += s.size();
+}
+
+void JsonWriter::putNumber(std::int64_t v) {
+    char text[24];
+    std::to_chars_result result = std::to_chars(text, text + sizeof(text), v);
+    put(std::string_view(text, result.ptr - text));
+}
+
+void JsonWriter::putString(std::string_view s) {
+    put('"');
+
+    size_t start = 0; //plain bytes are copied by runs
+    for (size_t i = 0; i < s.size(); ++i) {
+        byte c = (byte)s[i];
+        if (c >= 0x20 && c < 0x80 && c != '"' && c != '\\')
+            continue;
+
+        put(s.substr(start, i - start));
+        start = i + 1;
+
+        switch (c) {
+        case '"':  put("\\\""); break;
+        case '\\': put("\\\\"); break;
+        case '\n': put("\\n"); break;
+        case '\r': put("\\r"); break;
+        case '\t': put("\\t"); break;
+        default: {
+            char escape[6] = { '\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 15] };
+            put(std::string_view(escape, sizeof(escape)));
+        }
+        }
+    }
+
+    put(s.substr(start));
+    put('"');
+}
+
+void JsonWriter::separator() {
+    if (needComma)
+        put(',');
+}
+
+void JsonWriter::beginObject() {
+    separator();
+    put('{');
+    needComma = false;
+}
+
+void JsonWriter::endObject() {
+    put('}');
+    needComma = true;
+}
+
+void JsonWriter::beginArray() {
+    separator();
+    put('[');
+    needComma = false;
+}
+
+void JsonWriter::endArray() {
+    put(']');
+    needComma = true;
+}
+
+void JsonWriter::key(std::string_view name) {
+    separator();
+    putString(name);
+    put(':');
+    needComma = false;
+}
+
+void JsonWriter::key(int name) {
+    separator();
+    put('"');
+    putNumber(name);
+    put("\":");
+    needComma = false;
+}
+
+void JsonWriter::value(int v) {
+    separator();
+    putNumber(v);
+    needComma = true;
+}
+
+void JsonWriter::value(std::int64_t v) {
+    separator();
+    putNumber(v);
+    needComma = true;
+}
+
+void JsonWriter::value(float v) {
+    if (!std::isfinite(v)) {
+        null();
+        return;
+    }
+
+    separator();
+    char text[32];
+    std::to_chars_result result = std::to_chars(text, text + sizeof(text), v);
+    put(std::string_view(text, result.ptr - text));
+    needComma = true;
+}
+
+void JsonWriter::value(bool v) {
+    separator();
+    put(v ? std::string_view("true") : std::string_view("false"));
+    needComma = true;
+}
+
+void JsonWriter::value(std::string_view v) {
+    separator();
+    putString(v);
+    needComma = true;
+}
+
+void JsonWriter::null() {
+    separator();
+    put("null");
+    needComma = true;
+}
+
+void JsonWriter::newline() {
+    put('\n');
+    needComma = false;
+}
+
+/*
+
+Message serialization
+
+*/
+
+void writeMessageJson(JsonWriter& json, Message& message, int index) {
+    json.beginObject();
+    json.key("index");
+    json.value(index);
+    json.key("sequence");
+    json.value(message.getSeqNumber());
+
+    json.key("instructions");
+    json.beginArray();
+    for (int i = 0; i < message.getInstructionsCount(); ++i)
+        writeInstruction(json, message.getInstruction(i));
+    json.endArray();
+
+    json.endObject();
+}
+
+DEMO_NAMESPACE_END
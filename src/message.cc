@@ -1,11 +1,15 @@
 #include <jka/message.h>
 #include <jka/messagebuffer.h>
+#include <jka/string_arena.h>
 #include <jka/defs.h>
 
 DEMO_NAMESPACE_START
 
-bool Message::forceVehicleLoad = false;
-MessageBuffer Message::buffer;
+//decoding scratch state is per thread, so that several demos (or several
+//segments of one demo) can be decoded concurrently
+thread_local bool Message::forceVehicleLoad = false;
+thread_local MessageBuffer Message::buffer;
+thread_local StringArena* Message::strings = 0;
 
 class MessageImpl {
 public:
@@ -13,22 +17,15 @@ public:
     int  sequenceNumber;
     int  reliableAcknowledge;
     bool loaded;
+    bool modified; //header or instruction list changed since load
 
     std::vector<Instruction*> instructions;
+    StringArena               strings; //decoded strings, instructions hold views
 };
 
-void Message::load(std::ifstream& is) {
-    int msglen;
-
-    is.read((char*)&(impl->sequenceNumber), sizeof(impl->sequenceNumber));
-    is.read((char*)&(msglen), sizeof(msglen));
-
-    if ((impl->sequenceNumber == -1 && msglen == -1) || is.fail()) //ending message
-        return;
-
-    //load data field to special buffer
-    //which knows how to read it
-    Message::buffer.load(is, msglen);
+//decodes instructions from Message::buffer, which holds whole message data
+static void decodeInstructions(MessageImpl* impl) {
+    Message::strings = &impl->strings;
 
     try {
 
@@ -75,14 +72,52 @@ void Message::load(std::ifstream& is) {
     }
     catch (std::exception& e) {
         Message::buffer.clean();
+        Message::strings = 0;
         throw e;
     }
 
+    Message::strings = 0;
+
     impl->loaded = true; //successfully loaded
     Message::buffer.clean();
+
+    //decoding goes through setters, content is not modified yet
+    impl->modified = false;
+    for (std::vector<Instruction*>::iterator it = impl->instructions.begin();
+        it != impl->instructions.end(); ++it)
+        (*it)->setModified(false);
+}
+
+void Message::load(std::istream& is) {
+    int msglen;
+
+    is.read((char*)&(impl->sequenceNumber), sizeof(impl->sequenceNumber));
+    is.read((char*)&(msglen), sizeof(msglen));
+
+    if ((impl->sequenceNumber == -1 && msglen == -1) || is.fail()) //ending message
+        return;
+
+    if (msglen < 0 || msglen > MAX_MSGLEN)
+        throw DemoException("message length out of range");
+
+    //load data field to special buffer
+    //which knows how to read it
+    Message::buffer.load(is, msglen);
+
+    decodeInstructions(impl);
 }
 
-void Message::save(std::ofstream& os) const {
+void Message::load(int sequenceNumber, const byte* data, int length) {
+    if (length < 0 || length > MAX_MSGLEN)
+        throw DemoException("message length out of range");
+
+    impl->sequenceNumber = sequenceNumber;
+    Message::buffer.load(data, length);
+
+    decodeInstructions(impl);
+}
+
+void Message::save(std::ostream& os) const {
     Message::buffer.clean();
 
     Message::buffer.writeBits(impl->reliableAcknowledge, SIZE_32BITS);
@@ -102,6 +137,7 @@ void Message::save(std::ofstream& os) const {
 
 Message::Message() : impl(new MessageImpl()) {
     impl->loaded = false;
+    impl->modified = false;
 };
 
 Message::~Message() {
@@ -120,12 +156,34 @@ bool Message::isLoad() const {
 
 void Message::setSeqNumber(int seq) {
     impl->sequenceNumber = seq;
+    impl->modified = true;
 };
 
 void Message::setRelAcknowledge(int rel) {
     impl->reliableAcknowledge = rel;
+    impl->modified = true;
 };
 
+bool Message::isModified() const {
+    if (impl->modified)
+        return true;
+
+    for (std::vector<Instruction*>::const_iterator it = impl->instructions.begin();
+        it != impl->instructions.end(); ++it)
+        if ((*it)->isModified())
+            return true;
+
+    return false;
+}
+
+void Message::setModified(bool value) {
+    impl->modified = value;
+
+    for (std::vector<Instruction*>::iterator it = impl->instructions.begin();
+        it != impl->instructions.end(); ++it)
+        (*it)->setModified(value);
+}
+
 int Message::getSeqNumber() const {
     return impl->sequenceNumber;
 };
@@ -155,6 +213,16 @@ void Message::deleteInstruction(int id, int n) {
 
     impl->instructions.erase(impl->instructions.begin() + id,
         impl->instructions.begin() + id + n);
+
+    impl->modified = true;
+}
+
+void Message::insertInstruction(int id, Instruction* instruction) {
+    assert(instruction);
+    assert((id >= 0) && (id <= (int)impl->instructions.size()));
+
+    impl->instructions.insert(impl->instructions.begin() + id, instruction);
+    impl->modified = true;
 }
 
 void Message::clear() {
@@ -163,6 +231,8 @@ void Message::clear() {
     }
 
     impl->instructions.clear();
+    impl->strings.clear();
+    impl->modified = true;
 }
 
 bool Message::saveMessage(std::ofstream& os) const {
@@ -1,4 +1,5 @@
 #include <jka/messagebuffer.h>
+#include <jka/string_arena.h>
 
 DEMO_NAMESPACE_START
 
@@ -9,16 +10,23 @@ void MessageBuffer::clean() {
     currentPosition = length = 0;
 }
 
-void MessageBuffer::save(std::ofstream& dest) {
+void MessageBuffer::save(std::ostream& dest) {
     dest.write((char*)&buffer, length);
 }
 
-void MessageBuffer::load(std::ifstream& source, int len) {
+void MessageBuffer::load(std::istream& source, int len) {
     clean();
     source.read((char*)&buffer, len);
     length = len;
 }
 
+//one copy: the bit reader only works on buffer
+void MessageBuffer::load(const byte* data, int len) {
+    clean();
+    std::copy(data, data + len, buffer);
+    length = len;
+}
+
 void MessageBuffer::writeBits(int value, int bitSize) {
     if (bitSize < 0) {
         bitSize = -bitSize;
@@ -74,7 +82,7 @@ int MessageBuffer::readBits(int bitSize) {
     return value;
 }
 
-void MessageBuffer::writeString(const std::string& s, bool big = false) {
+void MessageBuffer::writeString(std::string_view s, bool big = false) {
     unsigned limit = big ? BIG_INFO_STRING : MAX_STRING_CHARS;
 
     if (s.size() >= limit) {
@@ -88,20 +96,42 @@ void MessageBuffer::writeString(const std::string& s, bool big = false) {
     writeBits(0, SIZE_8BITS); // ending sign
 }
 
-std::string MessageBuffer::readString(bool big = false) {
-    std::string str;
-    unsigned    limit = big ? BIG_INFO_STRING : MAX_STRING_CHARS;
+//reads characters into dest (BIG_INFO_STRING bytes), returns length
+int MessageBuffer::readChars(char* dest, bool big) {
+    int limit = big ? BIG_INFO_STRING : MAX_STRING_CHARS;
+    int count = 0;
 
-    int c;
-    do {
-        c = readBits(SIZE_8BITS);
+    while (count < limit - 1) {
+        int c = readBits(SIZE_8BITS);
         if (c == 0)
             break;
 
-        str += c;
-    } while (str.size() < limit - 1);
+        dest[count++] = (char)c;
+    }
+
+    return count;
+}
+
+std::string MessageBuffer::readString(bool big = false) {
+    char str[BIG_INFO_STRING];
+    int count = readChars(str, big);
+
+    return std::string(str, count);
+}
+
+std::string_view MessageBuffer::readStringView(StringArena& arena, bool big = false) {
+    char str[BIG_INFO_STRING];
+    int count = readChars(str, big);
+
+    return arena.store(std::string_view(str, count));
+}
+
+//reads a string and drops it, nothing is stored
+void MessageBuffer::skipString(bool big = false) {
+    int limit = big ? BIG_INFO_STRING : MAX_STRING_CHARS;
 
-    return str;
+    for (int count = 0; count < limit - 1 && readBits(SIZE_8BITS) != 0; ++count)
+        ;
 }
 
 void MessageBuffer::initHuffman() {
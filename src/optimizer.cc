@@ -0,0 +1,128 @@
+#include <jka/optimizer.h>
+#include <jka/snapshot_resolver.h>
+
+#include <algorithm>
+
+DEMO_NAMESPACE_START
+
+namespace {
+
+/// Erases entity entries of delta snapshot which base already holds unchanged.
+int dropUnchangedEntities(Snapshot* snap, const Snapshot* base) {
+    int dropped = 0;
+    std::map<int, EntityState>& entities = snap->getEntities();
+
+    for (std::map<int, EntityState>::iterator it = entities.begin(); it != entities.end();) {
+        //entity missing in base must stay, even empty, to be created
+        if (it->second.noChanged() && !it->second.isRemoved()
+            && base->getEntities().find(it->first) != base->getEntities().end()) {
+            entities.erase(it++);
+            ++dropped;
+        }
+        else {
+            ++it;
+        }
+    }
+
+    if (dropped)
+        snap->setModified(true);
+
+    return dropped;
+}
+
+}
+
+DemoOptimizer::DemoOptimizer(Demo& demo)
+    : demo(demo), deltaKeyframes(true), rebaseDeltas(false), dropEntities(true), dropCommands(true) {
+}
+
+void DemoOptimizer::run() {
+    stats = OptimizerStats();
+
+    SnapshotResolver resolver;
+    int commandSequence = -1;  //last command client has executed
+    int previousSequence = -1; //last message with a full snapshot since gamestate
+
+    for (int i = 0; i < demo.getMessageCount(); ++i) {
+        bool wasLoaded = demo.isMessageLoaded(i);
+        Message* msg = demo.getMessage(i);
+
+        if (!msg || !msg->isLoad())
+            throw DemoException("cannot load message");
+
+        int sequence = msg->getSeqNumber();
+        std::shared_ptr<Snapshot> previous = resolver.find(previousSequence);
+
+        //frames must hold original content, resolve before changing anything
+        std::shared_ptr<Snapshot> frame = resolver.update(msg);
+
+        for (int j = 0; j < msg->getInstructionsCount();) {
+            Instruction* instr = msg->getInstruction(j);
+
+            if (Gamestate* gamestate = instr->getGamestate()) {
+                commandSequence = gamestate->getCommandSequence();
+
+                //first snapshot of new chain stays uncompressed
+                previous.reset();
+                previousSequence = -1;
+            }
+            else if (ServerCommand* command = instr->getServerCommand()) {
+                if (dropCommands && command->getSequenceNumber() <= commandSequence) {
+                    msg->deleteInstruction(j);
+                    ++stats.commandsDropped;
+                    continue;
+                }
+
+                commandSequence = std::max(commandSequence, command->getSequenceNumber());
+            }
+            else if (Snapshot* snap = instr->getSnapshot()) {
+                bool convert = false;
+
+                if (previous && sequence - previousSequence < PACKET_BACKUP) {
+                    if (!snap->getDeltanum() && deltaKeyframes) {
+                        convert = true;
+                        ++stats.keyframesConverted;
+                    }
+                    else if (snap->getDeltanum() && rebaseDeltas
+                        && sequence - snap->getDeltanum() != previousSequence) {
+                        std::shared_ptr<Snapshot> base = resolver.find(sequence - snap->getDeltanum());
+
+                        if (base) {
+                            snap->applyOn(base.get());
+                            snap->makeInit();
+                            snap->setDeltanum(0);
+
+                            convert = true;
+                            ++stats.snapshotsRebased;
+                        }
+                    }
+                }
+
+                if (convert) {
+                    //delta() zeroes attributes missing here only against an uncompressed base
+                    std::unique_ptr<Snapshot> base(previous->clone());
+                    base->setDeltanum(0);
+
+                    snap->delta(base.get());
+                    snap->setDeltanum(sequence - previousSequence);
+                }
+
+                if (snap->getDeltanum() && (dropEntities || convert)) {
+                    std::shared_ptr<Snapshot> base = resolver.find(sequence - snap->getDeltanum());
+                    if (base)
+                        stats.entitiesDropped += dropUnchangedEntities(snap, base.get());
+                }
+            }
+
+            ++j;
+        }
+
+        if (frame)
+            previousSequence = sequence;
+
+        if (!wasLoaded && !msg->isModified())
+            demo.unloadMessage(i);
+    }
+}
+
+DEMO_NAMESPACE_END
@@ -0,0 +1,406 @@
+#include <jka/parallel_exporter.h>
+#include <jka/bounded_queue.h>
+#include <jka/demo_block.h>
+#include <jka/json_writer.h>
+#include <jka/state.h>
+
+#include <charconv>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#ifdef JKA_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+DEMO_NAMESPACE_START
+
+namespace {
+
+const char CSV_HEADER[] = "message,sequence,serverTime,type,number,field,value\n";
+const int NO_NUMBER = -1;
+
+/// Messages handed to one worker, replaced by their text once formatted.
+struct Chunk {
+    int                    index;
+    int                    first;
+    std::vector<DemoBlock> blocks;
+    std::string            output;
+};
+
+void appendInt(std::string& out, int value) {
+    char text[16];
+    std::to_chars_result result = std::to_chars(text, text + sizeof(text), value);
+    out.append(text, result.ptr - text);
+}
+
+void appendFloat(std::string& out, float value) {
+    if (!std::isfinite(value))
+        return; //empty cell
+
+    char text[32];
+    std::to_chars_result result = std::to_chars(text, text + sizeof(text), value);
+    out.append(text, result.ptr - text);
+}
+
+void appendQuoted(std::string& out, std::string_view text) {
+    out += '"';
+    for (char c : text) {
+        if (c == '"')
+            out += '"';
+        out += c;
+    }
+    out += '"';
+}
+
+/// CSV rows of one message, sharing message, sequence, serverTime columns.
+class CsvMessage {
+public:
+    CsvMessage(std::string& out, int index, int sequence, int serverTime) : out(out) {
+        appendInt(prefix, index);
+        prefix += ',';
+        appendInt(prefix, sequence);
+        prefix += ',';
+        if (serverTime >= 0)
+            appendInt(prefix, serverTime);
+        prefix += ',';
+    }
+
+    void intRow(const char* type, int number, std::string_view field, int value) {
+        begin(type, number, field);
+        appendInt(out, value);
+        out += '\n';
+    }
+
+    void floatRow(const char* type, int number, std::string_view field, float value) {
+        begin(type, number, field);
+        appendFloat(out, value);
+        out += '\n';
+    }
+
+    void textRow(const char* type, int number, std::string_view value) {
+        begin(type, number, std::string_view());
+        appendQuoted(out, value);
+        out += '\n';
+    }
+
+    void state(const char* type, int number, const State& state) {
+        int count;
+        const Field* fields = state.getNetfields(count);
+
+        for (int i = 0; i < count; ++i) {
+            if (!state.isAttributeSet(i))
+                continue;
+
+            if (fields[i].type == FIELD_FLOAT)
+                floatRow(type, number, fields[i]._name, state.getAttributeFloat(i));
+            else
+                intRow(type, number, fields[i]._name, state.getAttributeInt(i));
+        }
+    }
+
+    void player(const char* type, const PlayerState& ps) {
+        state(type, NO_NUMBER, ps);
+        array(type, "stats", ps.getStats());
+        array(type, "persistant", ps.getPersistant());
+        array(type, "ammo", ps.getAmmo());
+        array(type, "powerups", ps.getPowerups());
+    }
+
+    void entities(const char* type, const std::map<int, EntityState>& entities) {
+        for (const auto& [number, entity] : entities) {
+            if (entity.isRemoved())
+                intRow(type, number, "removed", 1);
+            else
+                state(type, number, entity);
+        }
+    }
+
+private:
+    void begin(const char* type, int number, std::string_view field) {
+        out += prefix;
+        out += type;
+        out += ',';
+        if (number != NO_NUMBER)
+            appendInt(out, number);
+        out += ',';
+        out += field; //netfield names need no quoting
+        out += ',';
+    }
+
+    void array(const char* type, const char* name, const std::map<int, int>& values) {
+        std::string field;
+
+        for (const auto& [id, value] : values) {
+            field = name;
+            field += '[';
+            appendInt(field, id);
+            field += ']';
+            intRow(type, NO_NUMBER, field, value);
+        }
+    }
+
+    std::string& out;
+    std::string  prefix;
+};
+
+void writeMessageCsv(std::string& out, Message& message, int index) {
+    int serverTime = -1;
+    for (int i = 0; i < message.getInstructionsCount(); ++i) {
+        if (Snapshot* snapshot = message.getInstruction(i)->getSnapshot())
+            serverTime = snapshot->getServertime();
+    }
+
+    CsvMessage csv(out, index, message.getSeqNumber(), serverTime);
+
+    for (int i = 0; i < message.getInstructionsCount(); ++i) {
+        Instruction* instr = message.getInstruction(i);
+
+        if (Gamestate* gamestate = instr->getGamestate()) {
+            csv.intRow("gamestate", gamestate->getClientNumber(), "commandSequence", gamestate->getCommandSequence());
+            for (const auto& [id, value] : gamestate->getConfigStrings())
+                csv.textRow("configstring", id, value);
+            csv.entities("baseline", gamestate->getBaseEntities());
+        }
+        else if (ServerCommand* command = instr->getServerCommand()) {
+            csv.textRow("command", command->getSequenceNumber(), command->getCommand());
+        }
+        else if (Snapshot* snapshot = instr->getSnapshot()) {
+            csv.intRow("snapshot", NO_NUMBER, "deltaNum", snapshot->getDeltanum());
+            if (const PlayerState* ps = snapshot->getPlayerstate())
+                csv.player("player", *ps);
+            if (const PlayerState* vehicle = snapshot->getVehiclestate())
+                csv.player("vehicle", *vehicle);
+            csv.entities("entity", snapshot->getEntities());
+        }
+        else if (MapChange* mapChange = instr->getMapChange()) {
+            csv.textRow("map_change", NO_NUMBER, mapChange->getMapChange());
+        }
+    }
+}
+
+void formatChunk(Chunk& chunk, ExportFormat format) {
+    std::ostringstream json;
+    JsonWriter writer(json, 1 << 16);
+
+    for (size_t i = 0; i < chunk.blocks.size(); ++i) {
+        int id = chunk.first + (int)i;
+
+        Message msg;
+        if (!decodeDemoBlock(msg, chunk.blocks[i]))
+            throw DemoException("cannot decode message " + std::to_string(id));
+
+        if (format == EXPORT_CSV) {
+            writeMessageCsv(chunk.output, msg, id);
+        }
+        else {
+            writeMessageJson(writer, msg, id);
+            writer.newline();
+        }
+    }
+
+    if (format != EXPORT_CSV) {
+        writer.flush();
+        chunk.output = json.str();
+    }
+
+    chunk.blocks.clear();
+}
+
+#ifdef JKA_HAVE_ZSTD
+/// Replaces text by one zstd frame.
+void compress(ZSTD_CCtx* ctx, std::string& text, int level) {
+    std::string frame(ZSTD_compressBound(text.size()), '\0');
+
+    size_t size = ZSTD_compressCCtx(ctx, &frame[0], frame.size(), text.data(), text.size(), level);
+    if (ZSTD_isError(size))
+        throw DemoException(std::string("zstd compression failed: ") + ZSTD_getErrorName(size));
+
+    frame.resize(size);
+    text.swap(frame);
+}
+#endif
+
+}
+
+ParallelExporter::ParallelExporter(const Demo& demo)
+    : demo(demo), format(EXPORT_NDJSON), threadCount(0), chunkSize(256), compression(0) {
+}
+
+bool ParallelExporter::isCompressionSupported() {
+#ifdef JKA_HAVE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ParallelExporter::setCompression(int level) {
+    if (level && !isCompressionSupported())
+        throw DemoException("zstd compression is not available in this build");
+
+    compression = level;
+}
+
+bool ParallelExporter::write(std::ostream& os, int first, int last) {
+    if (last < 0 || last > demo.getMessageCount())
+        last = demo.getMessageCount();
+
+    int threads = threadCount > 0 ? threadCount : (int)std::thread::hardware_concurrency();
+    threads = std::max(1, threads);
+
+    //chunks read but not written yet
+    const int window = threads * 4;
+
+    if (format == EXPORT_CSV) {
+        std::string header(CSV_HEADER);
+#ifdef JKA_HAVE_ZSTD
+        if (compression) {
+            ZSTD_CCtx* ctx = ZSTD_createCCtx();
+            compress(ctx, header, compression);
+            ZSTD_freeCCtx(ctx);
+        }
+#endif
+        os.write(header.data(), header.size());
+    }
+
+    BoundedQueue<std::unique_ptr<Chunk>> jobs(threads * 2);
+    BoundedQueue<std::unique_ptr<Chunk>> done(window);
+
+    std::mutex mutex;
+    std::condition_variable progress;
+    int written = 0;
+    bool stop = false;
+    std::exception_ptr error;
+
+    auto fail = [&](std::exception_ptr e) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (e && !error)
+                error = e;
+            stop = true;
+        }
+        jobs.close();
+        done.close();
+        progress.notify_all();
+    };
+
+    auto worker = [&]() {
+#ifdef JKA_HAVE_ZSTD
+        ZSTD_CCtx* ctx = compression ? ZSTD_createCCtx() : 0;
+#endif
+        std::unique_ptr<Chunk> chunk;
+
+        while (jobs.pop(chunk)) {
+            try {
+                formatChunk(*chunk, format);
+#ifdef JKA_HAVE_ZSTD
+                if (ctx)
+                    compress(ctx, chunk->output, compression);
+#endif
+            }
+            catch (...) {
+                fail(std::current_exception());
+                break;
+            }
+
+            done.push(std::move(chunk));
+        }
+
+#ifdef JKA_HAVE_ZSTD
+        ZSTD_freeCCtx(ctx);
+#endif
+    };
+
+    //emits chunks in order, parks the ones finished early
+    auto writer = [&]() {
+        std::map<int, std::unique_ptr<Chunk>> pending;
+        std::unique_ptr<Chunk> chunk;
+        int next = 0;
+
+        while (done.pop(chunk)) {
+            int index = chunk->index;
+            pending[index] = std::move(chunk);
+
+            while (!pending.empty() && pending.begin()->first == next) {
+                const std::string& output = pending.begin()->second->output;
+                os.write(output.data(), output.size());
+                pending.erase(pending.begin());
+                ++next;
+            }
+
+            if (!os) {
+                fail(std::exception_ptr());
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                written = next;
+            }
+            progress.notify_all();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 0; i < threads; ++i)
+        pool.push_back(std::thread(worker));
+    std::thread writing(writer);
+
+    bool complete = true;
+    int chunks = 0;
+
+    try {
+        for (int id = first; id < last; id += chunkSize) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                progress.wait(lock, [&] { return stop || chunks - written < window; });
+                if (stop)
+                    break;
+            }
+
+            std::unique_ptr<Chunk> chunk(new Chunk());
+            chunk->index = chunks;
+            chunk->first = id;
+            chunk->blocks.resize(std::min(chunkSize, last - id));
+
+            for (size_t i = 0; i < chunk->blocks.size() && complete; ++i)
+                complete = demo.readRawMessage(id + (int)i, chunk->blocks[i]);
+
+            if (!complete || !jobs.push(std::move(chunk)))
+                break;
+            ++chunks;
+        }
+    }
+    catch (...) {
+        fail(std::current_exception());
+    }
+
+    jobs.close();
+    for (std::vector<std::thread>::iterator it = pool.begin(); it != pool.end(); ++it)
+        it->join();
+
+    done.close();
+    writing.join();
+
+    if (error)
+        std::rethrow_exception(error);
+
+    os.flush();
+    return complete && !stop && os.good();
+}
+
+bool ParallelExporter::write(const std::string& filename) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    return write(file);
+}
+
+DEMO_NAMESPACE_END
@@ -0,0 +1,287 @@
+#include <jka/rewriter.h>
+#include <jka/bg_defs.h>
+#include <jka/command_decoder.h>
+#include <jka/info_string.h>
+
+#include <cctype>
+#include <cstdlib>
+#include <map>
+
+DEMO_NAMESPACE_START
+
+namespace {
+
+bool isWordChar(const std::string& text, size_t pos) {
+    return pos < text.size() && isalnum((unsigned char)text[pos]);
+}
+
+/// Replaces occurrences of from not glued to letters or digits (a color
+/// code like ^7 right before still counts as a boundary).
+bool replaceWords(std::string& text, const std::string& from, const std::string& to, size_t pos = 0) {
+    bool replaced = false;
+    bool checkStart = isWordChar(from, 0);
+    bool checkEnd = isWordChar(from, from.size() - 1);
+
+    while ((pos = text.find(from, pos)) != std::string::npos) {
+        bool colored = pos >= 2 && text[pos - 2] == '^';
+        bool start = !checkStart || !pos || colored || !isWordChar(text, pos - 1);
+        bool end = !checkEnd || !isWordChar(text, pos + from.size());
+
+        if (start && end) {
+            text.replace(pos, from.size(), to);
+            pos += to.size();
+            replaced = true;
+        }
+        else {
+            ++pos;
+        }
+    }
+
+    return replaced;
+}
+
+/// Replaces dotted IPv4 addresses (with optional :port) by 0.0.0.0.
+bool maskAddresses(std::string& text) {
+    bool replaced = false;
+    size_t i = 0;
+
+    while (i < text.size()) {
+        if (!isdigit((unsigned char)text[i]) || (i && (isalnum((unsigned char)text[i - 1]) || text[i - 1] == '.'))) {
+            ++i;
+            continue;
+        }
+
+        //four groups of 1 to 3 digits
+        size_t end = i;
+        int groups = 0;
+
+        while (groups < 4) {
+            size_t digits = 0;
+            while (end < text.size() && isdigit((unsigned char)text[end]) && digits < 4) {
+                ++end;
+                ++digits;
+            }
+
+            if (!digits || digits > 3)
+                break;
+
+            if (++groups < 4) {
+                if (end >= text.size() || text[end] != '.')
+                    break;
+                ++end;
+            }
+        }
+
+        if (groups == 4 && (end >= text.size() || (!isalnum((unsigned char)text[end]) && text[end] != '.'))) {
+            if (text.compare(i, end - i, "0.0.0.0") != 0) {
+                text.replace(i, end - i, "0.0.0.0");
+                replaced = true;
+            }
+            i += 7;
+        }
+        else {
+            i = end > i ? end : i + 1;
+        }
+    }
+
+    return replaced;
+}
+
+/// Aliases given to player names, shared by anonymize rules.
+class PlayerAliases {
+public:
+    explicit PlayerAliases(const std::string& prefix) : prefix(prefix) {}
+
+    const std::string& get(const std::string& name) {
+        std::map<std::string, std::string>::iterator it = aliases.find(name);
+        if (it != aliases.end())
+            return it->second;
+
+        std::string alias = prefix + std::to_string(aliases.size() + 1);
+
+        //longest names first, so that a name containing another one wins
+        std::vector<std::string>::iterator pos = names.begin();
+        while (pos != names.end() && pos->size() >= name.size())
+            ++pos;
+        names.insert(pos, name);
+
+        return aliases[name] = alias;
+    }
+
+    bool isAlias(const std::string& name) const {
+        for (std::map<std::string, std::string>::const_iterator it = aliases.begin(); it != aliases.end(); ++it)
+            if (it->second == name)
+                return true;
+
+        return false;
+    }
+
+    /// Replaces known names in free text as whole words, from position pos.
+    bool replaceNames(std::string& text, size_t pos) const {
+        bool replaced = false;
+
+        for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it)
+            if (!it->empty())
+                replaced |= replaceWords(text, *it, aliases.find(*it)->second, pos);
+
+        return replaced;
+    }
+
+private:
+    std::string                        prefix;
+    std::map<std::string, std::string> aliases;
+    std::vector<std::string>           names;
+};
+
+}
+
+DemoRewriter::DemoRewriter(Demo& demo) : demo(demo) {
+}
+
+void DemoRewriter::addConfigstringRule(ConfigstringRule rule) {
+    configstringRules.push_back(rule);
+}
+
+void DemoRewriter::addCommandRule(CommandRule rule) {
+    commandRules.push_back(rule);
+}
+
+void DemoRewriter::addAnonymizeRules(const std::string& prefix) {
+    std::shared_ptr<PlayerAliases> players(new PlayerAliases(prefix));
+
+    addConfigstringRule([players](int index, std::string& value) {
+        bool changed = maskAddresses(value);
+
+        if (index < CS_PLAYERS || index >= CS_PLAYERS + MAX_CLIENTS)
+            return changed;
+
+        std::string_view found = InfoStringView(value).value("n");
+        if (found.empty())
+            return changed;
+
+        size_t start = found.data() - value.data();
+        std::string name(found);
+
+        if (players->isAlias(name))
+            return changed;
+
+        value.replace(start, name.size(), players->get(name));
+        return true;
+    });
+
+    addCommandRule([players](std::string& command) {
+        bool changed = maskAddresses(command);
+
+        size_t verbEnd = command.find(' ');
+        if (verbEnd == std::string::npos)
+            return changed;
+
+        ServerCommandType type = getServerCommandType(std::string_view(command).substr(0, verbEnd));
+        if (type == SCMD_CHAT || type == SCMD_TCHAT || type == SCMD_PRINT || type == SCMD_CP)
+            changed |= players->replaceNames(command, verbEnd);
+
+        return changed;
+    });
+}
+
+bool DemoRewriter::rewriteConfigstring(int index, std::string& value) const {
+    bool changed = false;
+
+    for (std::vector<ConfigstringRule>::const_iterator it = configstringRules.begin();
+        it != configstringRules.end(); ++it)
+        changed |= (*it)(index, value);
+
+    return changed;
+}
+
+bool DemoRewriter::rewriteCommand(std::string& command) const {
+    //cs <index> "<value>"
+    if (command.compare(0, 3, "cs ") == 0) {
+        size_t start = command.find('"');
+        size_t end = command.rfind('"');
+
+        if (start == std::string::npos || end <= start)
+            return false;
+
+        int index = atoi(command.c_str() + 3);
+        std::string value = command.substr(start + 1, end - start - 1);
+
+        if (!rewriteConfigstring(index, value))
+            return false;
+
+        command = "cs " + std::to_string(index) + " \"" + value + "\"";
+        return true;
+    }
+
+    bool changed = false;
+
+    for (std::vector<CommandRule>::const_iterator it = commandRules.begin();
+        it != commandRules.end(); ++it)
+        changed |= (*it)(command);
+
+    return changed;
+}
+
+int DemoRewriter::run() {
+    int changed = 0;
+    MessagePeek peek;
+
+    for (int i = 0; i < demo.getMessageCount(); ++i) {
+        if (!demo.peekMessage(i, peek))
+            throw DemoException("cannot read message");
+
+        //commands and gamestate precede snapshot, nothing to rewrite otherwise
+        if (!peek.hasGamestate && !peek.serverCommands)
+            continue;
+
+        bool wasLoaded = demo.isMessageLoaded(i);
+        Message* msg = demo.getMessage(i);
+
+        if (!msg || !msg->isLoad())
+            throw DemoException("cannot load message");
+
+        bool dirty = false;
+
+        for (int j = 0; j < msg->getInstructionsCount(); ++j) {
+            Instruction* instr = msg->getInstruction(j);
+
+            if (Gamestate* gamestate = instr->getGamestate()) {
+                std::map<int, std::string> rewritten;
+
+                for (std::map<int, std::string_view>::const_iterator it = gamestate->getConfigStrings().begin();
+                    it != gamestate->getConfigStrings().end(); ++it) {
+                    std::string value(it->second);
+                    if (rewriteConfigstring(it->first, value))
+                        rewritten[it->first] = value;
+                }
+
+                for (std::map<int, std::string>::iterator it = rewritten.begin(); it != rewritten.end(); ++it)
+                    gamestate->setConfigstring(it->first, it->second);
+
+                dirty |= !rewritten.empty();
+            }
+            else if (ServerCommand* command = instr->getServerCommand()) {
+                std::string text(command->getCommand());
+
+                if (rewriteCommand(text)) {
+                    command->setCommand(text);
+                    dirty = true;
+                }
+            }
+        }
+
+        if (dirty)
+            ++changed;
+        else if (!wasLoaded)
+            demo.unloadMessage(i);
+    }
+
+    return changed;
+}
+
+bool DemoRewriter::write(std::string_view filename) {
+    run();
+    return demo.save(filename, true);
+}
+
+DEMO_NAMESPACE_END
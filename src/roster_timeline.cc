@@ -0,0 +1,182 @@
+#include <jka/roster_timeline.h>
+#include <jka/command_tokenizer.h>
+#include <jka/info_string.h>
+
+#include <algorithm>
+#include <cctype>
+#include <tuple>
+
+DEMO_NAMESPACE_START
+
+bool RosterTimeline::NameKey::operator<(const NameKey& other) const {
+    return std::tie(key, clientNum, entry) < std::tie(other.key, other.clientNum, other.entry);
+}
+
+RosterTimeline::RosterTimeline() {
+    clear();
+}
+
+void RosterTimeline::clear() {
+    slots.assign(MAX_CLIENTS, std::vector<RosterEntry>());
+    names.clear();
+    namesDirty = false;
+}
+
+void RosterTimeline::build(const ConfigstringTimeline& timeline) {
+    clear();
+
+    for (int c = 0; c < MAX_CLIENTS; ++c) {
+        const std::vector<ConfigstringTimeline::Version>& versions = timeline.getVersions(CS_PLAYERS + c);
+
+        for (const ConfigstringTimeline::Version& version : versions)
+            update(c, version.messageId, version.serverTime, version.value);
+    }
+}
+
+void RosterTimeline::update(int clientNum, int messageId, int serverTime, std::string_view info) {
+    if (clientNum < 0 || clientNum >= MAX_CLIENTS)
+        return;
+
+    std::vector<RosterEntry>& list = slots[clientNum];
+    RosterEntry* open = (!list.empty() && list.back().endMessage < 0) ? &list.back() : 0;
+
+    if (open) {
+        if (open->info == info)
+            return;
+
+        open->endTime = serverTime;
+        open->endMessage = messageId;
+    }
+
+    namesDirty = true;
+
+    if (info.empty()) //disconnected
+        return;
+
+    InfoStringView parsed(info);
+
+    RosterEntry entry;
+    entry.clientNum = clientNum;
+    entry.startTime = serverTime;
+    entry.endTime = -1;
+    entry.startMessage = messageId;
+    entry.endMessage = -1;
+    entry.name = parsed.value("n");
+    entry.team = CommandTokenizer::toInt(parsed.value("t"));
+    entry.model = parsed.value("model");
+    entry.info = info;
+
+    if (!open)
+        entry.change = ROSTER_CONNECT;
+    else if (entry.name != open->name)
+        entry.change = ROSTER_RENAME;
+    else if (entry.team != open->team)
+        entry.change = ROSTER_TEAM;
+    else
+        entry.change = ROSTER_INFO;
+
+    list.push_back(entry);
+}
+
+const RosterEntry* RosterTimeline::at(int clientNum, int serverTime) const {
+    if (clientNum < 0 || clientNum >= MAX_CLIENTS)
+        return 0;
+
+    const std::vector<RosterEntry>& list = slots[clientNum];
+    auto it = std::upper_bound(list.begin(), list.end(), serverTime,
+        [](int time, const RosterEntry& entry) { return time < entry.startTime; });
+
+    if (it == list.begin() || !(it - 1)->contains(serverTime))
+        return 0;
+
+    return &*(it - 1);
+}
+
+const RosterEntry* RosterTimeline::atMessage(int clientNum, int messageId) const {
+    if (clientNum < 0 || clientNum >= MAX_CLIENTS)
+        return 0;
+
+    const std::vector<RosterEntry>& list = slots[clientNum];
+    auto it = std::upper_bound(list.begin(), list.end(), messageId,
+        [](int id, const RosterEntry& entry) { return id < entry.startMessage; });
+
+    if (it == list.begin())
+        return 0;
+
+    const RosterEntry& entry = *(it - 1);
+    if (entry.endMessage >= 0 && messageId >= entry.endMessage)
+        return 0;
+
+    return &entry;
+}
+
+std::vector<const RosterEntry*> RosterTimeline::playersAt(int serverTime) const {
+    std::vector<const RosterEntry*> players(MAX_CLIENTS);
+
+    for (int c = 0; c < MAX_CLIENTS; ++c)
+        players[c] = at(c, serverTime);
+
+    return players;
+}
+
+std::vector<RosterEntry> RosterTimeline::findByName(std::string_view name) const {
+    indexNames();
+
+    NameKey key;
+    key.key = cleanName(name);
+    key.clientNum = -1;
+    key.entry = -1;
+
+    std::vector<RosterEntry> found;
+    for (auto it = std::lower_bound(names.begin(), names.end(), key); it != names.end() && it->key == key.key; ++it)
+        found.push_back(slots[it->clientNum][it->entry]);
+
+    return found;
+}
+
+int RosterTimeline::getEntriesCount() const {
+    int count = 0;
+
+    for (const std::vector<RosterEntry>& list : slots)
+        count += (int)list.size();
+
+    return count;
+}
+
+std::string RosterTimeline::cleanName(std::string_view name) {
+    std::string clean;
+    clean.reserve(name.size());
+
+    for (size_t i = 0; i < name.size(); ++i) {
+        if (name[i] == '^' && i + 1 < name.size() && name[i + 1] != '^') {
+            ++i; //color code
+            continue;
+        }
+
+        clean += (char)tolower((unsigned char)name[i]);
+    }
+
+    return clean;
+}
+
+void RosterTimeline::indexNames() const {
+    if (!namesDirty)
+        return;
+
+    names.clear();
+
+    for (int c = 0; c < MAX_CLIENTS; ++c) {
+        for (int e = 0; e < (int)slots[c].size(); ++e) {
+            NameKey key;
+            key.key = cleanName(slots[c][e].name);
+            key.clientNum = c;
+            key.entry = e;
+            names.push_back(std::move(key));
+        }
+    }
+
+    std::sort(names.begin(), names.end());
+    namesDirty = false;
+}
+
+DEMO_NAMESPACE_END
@@ -0,0 +1,86 @@
+#include <jka/snapshot_resolver.h>
+
+DEMO_NAMESPACE_START
+
+SnapshotResolver::SnapshotResolver() {
+    reset();
+}
+
+void SnapshotResolver::reset() {
+    for (int i = 0; i < PACKET_BACKUP; ++i) {
+        frames[i].reset();
+        frameSequence[i] = -1;
+    }
+}
+
+std::shared_ptr<Snapshot> SnapshotResolver::update(Message* message) {
+    std::shared_ptr<Snapshot> resolved;
+
+    if (!message)
+        return resolved;
+
+    for (int i = 0; i < message->getInstructionsCount(); ++i) {
+        Instruction* instr = message->getInstruction(i);
+
+        if (instr->getType() == INSTR_GAMESTATE)
+            reset(); //new delta chain, old frames are not valid anymore
+        else if (instr->getType() == INSTR_SNAPSHOT)
+            resolved = resolve(message->getSeqNumber(), instr->getSnapshot());
+    }
+
+    return resolved;
+}
+
+std::shared_ptr<Snapshot> SnapshotResolver::resolve(int sequenceNumber, Snapshot* snapshot) {
+    assert(snapshot);
+
+    std::shared_ptr<Snapshot> frame(snapshot->clone());
+
+    if (snapshot->getDeltanum()) {
+        std::shared_ptr<Snapshot> base = find(sequenceNumber - snapshot->getDeltanum());
+
+        if (base) {
+            frame->applyOn(base.get());
+            frame->makeInit();
+        }
+        else {
+            frame.reset(); //base not received
+        }
+    }
+
+    int slot = sequenceNumber & (PACKET_BACKUP - 1);
+    frames[slot] = frame;
+    frameSequence[slot] = frame ? sequenceNumber : -1;
+
+    return frame;
+}
+
+std::shared_ptr<Snapshot> SnapshotResolver::find(int sequenceNumber) const {
+    int slot = sequenceNumber & (PACKET_BACKUP - 1);
+
+    if (sequenceNumber < 0 || frameSequence[slot] != sequenceNumber)
+        return std::shared_ptr<Snapshot>();
+
+    return frames[slot];
+}
+
+bool SnapshotResolver::uncompress(Message* message) const {
+    for (int i = 0; i < message->getInstructionsCount(); ++i) {
+        Snapshot* snap = message->getInstruction(i)->getSnapshot();
+
+        if (!snap || !snap->getDeltanum())
+            continue;
+
+        std::shared_ptr<Snapshot> base = find(message->getSeqNumber() - snap->getDeltanum());
+        if (!base)
+            return false;
+
+        snap->applyOn(base.get());
+        snap->makeInit();
+        snap->setDeltanum(0);
+    }
+
+    return true;
+}
+
+DEMO_NAMESPACE_END
@@ -0,0 +1,305 @@
+#include <jka/splicer.h>
+#include <jka/configstring_folder.h>
+#include <jka/demo_block.h>
+#include <jka/demo_writer.h>
+#include <jka/snapshot_resolver.h>
+
+#include <fstream>
+#include <utility>
+
+DEMO_NAMESPACE_START
+
+namespace {
+
+const size_t MAX_CONFIGSTRING_CHUNK = MAX_STRING_CHARS - 24; //as server splits them
+
+Gamestate* findGamestate(Message& message) {
+    for (int i = 0; i < message.getInstructionsCount(); ++i)
+        if (message.getInstruction(i)->getType() == INSTR_GAMESTATE)
+            return message.getInstruction(i)->getGamestate();
+
+    return 0;
+}
+
+/// Commands setting configstring, split in bcs0/1/2 fragments when too long.
+void configstringCommands(int index, std::string_view value, std::vector<std::string>& commands) {
+    std::string id = std::to_string(index);
+
+    if (value.size() < MAX_CONFIGSTRING_CHUNK) {
+        commands.push_back("cs " + id + " \"" + std::string(value) + "\"");
+        return;
+    }
+
+    for (size_t pos = 0; pos < value.size(); pos += MAX_CONFIGSTRING_CHUNK) {
+        const char* verb = !pos ? "bcs0" : (value.size() - pos <= MAX_CONFIGSTRING_CHUNK ? "bcs2" : "bcs1");
+        commands.push_back(std::string(verb) + " " + id + " \"" + std::string(value.substr(pos, MAX_CONFIGSTRING_CHUNK)) + "\"");
+    }
+}
+
+/// Output state carried from one range to the next.
+class SpliceOutput {
+public:
+    explicit SpliceOutput(std::ostream& os)
+        : writer(os), demo(0), end(-1), gamestateId(-1), lastSequence(0),
+        commandSequence(0), commandShift(0), baseFloor(0) {}
+
+    bool writeRange(const Demo& source, int first, int last);
+
+    void finish() { writer.writeEnd(); }
+    bool isGood() const { return writer.isGood(); }
+
+private:
+    bool start(const Demo& source, int first, int& copyStart);
+    bool copy(int first, int last);
+    bool updateCommandSequence(int first, int last);
+
+    DemoWriter       writer;
+    const Demo*      demo;            //source being copied, null before first range
+    int              end;             //source message following last one written
+    int              gamestateId;     //source gamestate in effect at end
+    int              lastSequence;    //last sequence number written
+    int              commandSequence; //last server command number written
+    int              commandShift;    //added to source command numbers
+    int              baseFloor;       //source deltas against older messages are uncompressed
+    SnapshotResolver resolver;        //source frames preceding range
+
+    std::vector<std::string> pending; //commands sent with first message of range
+};
+
+bool SpliceOutput::writeRange(const Demo& source, int first, int last) {
+    int count = source.getMessageCount();
+    if (last < 0 || last > count)
+        last = count;
+
+    if (first < 0)
+        return false;
+    if (first >= last)
+        return true;
+
+    //continuing previous range, copy goes on with same numbering
+    if (demo != &source || end != first) {
+        if (!start(source, first, first))
+            return false;
+    }
+
+    demo = &source;
+
+    if (!copy(first, last) || !updateCommandSequence(first, last))
+        return false;
+
+    end = last;
+    return true;
+}
+
+bool SpliceOutput::start(const Demo& source, int first, int& copyStart) {
+    MessagePeek peek;
+
+    int g = first;
+    for (; g >= 0; --g) {
+        if (!source.peekMessage(g, peek))
+            return false;
+        if (peek.hasGamestate)
+            break;
+    }
+
+    if (g < 0)
+        return false;
+
+    //messages removed inside one gamestate, client state can be kept
+    bool gap = (demo == &source && gamestateId == g && end < first);
+
+    DemoBlock block;
+    Message gamestateMessage;
+
+    if (!source.readRawMessage(g, block) || !decodeDemoBlock(gamestateMessage, block))
+        return false;
+
+    Gamestate* gamestate = findGamestate(gamestateMessage);
+    if (!gamestate)
+        return false;
+
+    //replay what precedes range: configstrings, command number, frames
+    ConfigstringFolder folder(gamestate);
+    std::map<int, std::string_view> before; //views stay valid, edits are appended
+
+    resolver.reset();
+    resolver.update(&gamestateMessage);
+
+    for (int i = g + 1; i < first; ++i) {
+        if (gap && i == end)
+            before = gamestate->getConfigStrings();
+
+        Message msg;
+        if (!source.readRawMessage(i, block) || !decodeDemoBlock(msg, block))
+            return false;
+
+        folder.update(&msg);
+        resolver.update(&msg);
+    }
+
+    if (!demo)
+        commandSequence = folder.getCommandSequence(); //keep source numbering
+
+    pending.clear();
+
+    if (gap) {
+        const std::map<int, std::string_view>& now = gamestate->getConfigStrings();
+
+        for (std::map<int, std::string_view>::const_iterator it = now.begin(); it != now.end(); ++it) {
+            std::map<int, std::string_view>::const_iterator old = before.find(it->first);
+            if (old == before.end() || old->second != it->second)
+                configstringCommands(it->first, it->second, pending);
+        }
+
+        for (std::map<int, std::string_view>::const_iterator it = before.begin(); it != before.end(); ++it)
+            if (now.find(it->first) == now.end())
+                configstringCommands(it->first, "", pending);
+
+        copyStart = first;
+    }
+    else {
+        //client restarts from gamestate, commands it carries are stale
+        for (int j = gamestateMessage.getInstructionsCount() - 1; j >= 0; --j)
+            if (gamestateMessage.getInstruction(j)->getType() == INSTR_SERVERCOMMAND)
+                gamestateMessage.deleteInstruction(j);
+
+        gamestate->setCommandSequence(commandSequence);
+        gamestateMessage.setSeqNumber(++lastSequence);
+
+        writer.setSequenceShift(0);
+        writer.writeMessage(gamestateMessage);
+
+        copyStart = (first == g) ? g + 1 : first;
+    }
+
+    gamestateId = g;
+    commandShift = commandSequence + (int)pending.size() - folder.getCommandSequence();
+
+    if (copyStart < source.getMessageCount()) {
+        if (!source.peekMessage(copyStart, peek))
+            return false;
+
+        writer.setSequenceShift(lastSequence + 1 - peek.sequenceNumber);
+        baseFloor = peek.sequenceNumber;
+    }
+
+    return true;
+}
+
+bool SpliceOutput::copy(int first, int last) {
+    DemoBlock block;
+    MessagePeek peek;
+
+    for (int i = first; i < last; ++i) {
+        if (!demo->peekMessage(i, peek) || !demo->readRawMessage(i, block))
+            return false;
+
+        if (peek.hasGamestate)
+            gamestateId = i;
+
+        int base = peek.deltaSequence();
+        bool uncompress = (base >= 0 && base < baseFloor);
+
+        if (pending.empty() && !uncompress && !(commandShift && (peek.serverCommands || peek.hasGamestate))) {
+            writer.writeBlock(block);
+        }
+        else {
+            Message msg;
+
+            if (!decodeDemoBlock(msg, block) || (uncompress && !resolver.uncompress(&msg)))
+                return false;
+
+            for (int j = 0; j < msg.getInstructionsCount(); ++j) {
+                Instruction* instr = msg.getInstruction(j);
+
+                if (ServerCommand* command = instr->getServerCommand())
+                    command->setSequenceNumber(command->getSequenceNumber() + commandShift);
+                else if (Gamestate* gamestate = instr->getGamestate())
+                    gamestate->setCommandSequence(gamestate->getCommandSequence() + commandShift);
+            }
+
+            //numbered right after commands already written, before resent ones
+            for (size_t j = 0; j < pending.size(); ++j) {
+                ServerCommand* command = new ServerCommand();
+                command->setSequenceNumber(commandSequence + (int)j + 1);
+                command->setCommand(pending[j]);
+
+                msg.insertInstruction((int)j, command);
+            }
+
+            commandSequence += (int)pending.size();
+            pending.clear();
+
+            writer.writeMessage(msg);
+        }
+
+        lastSequence = peek.sequenceNumber + writer.getSequenceShift();
+    }
+
+    return true;
+}
+
+//commands are resent until acknowledged, last message holding some has the highest
+bool SpliceOutput::updateCommandSequence(int first, int last) {
+    MessagePeek peek;
+
+    for (int i = last - 1; i >= first; --i) {
+        if (!demo->peekMessage(i, peek))
+            return false;
+
+        if (!peek.serverCommands && !peek.hasGamestate)
+            continue;
+
+        DemoBlock block;
+        Message msg;
+
+        if (!demo->readRawMessage(i, block) || !decodeDemoBlock(msg, block))
+            return false;
+
+        int highest = -1;
+        for (int j = 0; j < msg.getInstructionsCount(); ++j) {
+            Instruction* instr = msg.getInstruction(j);
+
+            if (ServerCommand* command = instr->getServerCommand())
+                highest = std::max(highest, command->getSequenceNumber());
+            else if (Gamestate* gamestate = instr->getGamestate())
+                highest = std::max(highest, gamestate->getCommandSequence());
+        }
+
+        if (highest >= 0)
+            commandSequence = std::max(commandSequence, highest + commandShift);
+
+        return true;
+    }
+
+    return true;
+}
+
+}
+
+void DemoSplicer::addRange(const Demo& demo, int first, int last) {
+    Range range = { &demo, first, last };
+    ranges.push_back(range);
+}
+
+bool DemoSplicer::write(std::string_view filename) const {
+    std::ofstream os(std::string(filename), std::ios::binary);
+
+    if (!os.is_open())
+        return false;
+
+    return write(os) && os.good();
+}
+
+bool DemoSplicer::write(std::ostream& os) const {
+    SpliceOutput output(os);
+
+    for (std::vector<Range>::const_iterator it = ranges.begin(); it != ranges.end(); ++it)
+        if (!output.writeRange(*it->demo, it->first, it->last))
+            return false;
+
+    output.finish();
+    return output.isGood();
+}
+
+DEMO_NAMESPACE_END
@@ -19,10 +19,12 @@ int State::getAtributeInt(int id) const {
 }
 
 void State::setAtribute(int id, float value) {
+    modified = true;
     atributes[id].fVal = value;
 }
 
 void State::setAtribute(int id, int value) {
+    modified = true;
     atributes[id].iVal = value;
 }
 
@@ -30,6 +32,23 @@ bool State::isAtributeSet(int id) const {
     return (atributes.find(id) != (atributes.end()));
 }
 
+const Field* State::getNetfields(int& count) const noexcept {
+    switch (type) {
+    case STATE_PILOTSTATE:
+        count = sizeof(PilotNetfield) / sizeof(Field);
+        return PilotNetfield;
+    case STATE_VEHICLESTATE:
+        count = sizeof(VehicleNetfield) / sizeof(Field);
+        return VehicleNetfield;
+    case STATE_PLAYERSTATE:
+        count = sizeof(PlayerNetfield) / sizeof(Field);
+        return PlayerNetfield;
+    default:
+        count = sizeof(EntityNetfield) / sizeof(Field);
+        return EntityNetfield;
+    }
+}
+
 int State::getAtributesCount() {
     return (int)atributes.size();
 }
@@ -42,6 +61,7 @@ PlayerState* State::getPlayerstate() {
 }
 
 void State::clear() {
+    modified = true;
     atributes.clear();
 }
 
@@ -219,6 +239,7 @@ bool EntityState::isAtributeInteger(int id) const {
 }
 
 void EntityState::delta(const EntityState* state) {
+    modified = true;
     for (std::map<int, Atribute>::const_iterator it = state->atributes.begin();
         it != state->atributes.end(); ++it) {
 
@@ -235,6 +256,7 @@ void EntityState::delta(const EntityState* state) {
 }
 
 void EntityState::applyOn(const EntityState* state) {
+    modified = true;
     for (std::map<int, Atribute>::const_iterator it = state->atributes.begin();
         it != state->atributes.end(); ++it) {
 
@@ -245,6 +267,7 @@ void EntityState::applyOn(const EntityState* state) {
 }
 
 void EntityState::removeNull() {
+    modified = true;
     IntAtributeMap tempMap;
 
     for (IntAtributeMapCit it = atributes.begin();
@@ -516,6 +539,7 @@ bool PlayerState::isAtributeInteger(int id) const {
 
 void PlayerState::delta(const PlayerState* state, bool isUncompressed)
 {
+    modified = true;
     [[maybe_unused]] int test = 0;
 
     //update player's informations
@@ -590,6 +614,7 @@ void PlayerState::delta(const PlayerState* state, bool isUncompressed)
 }
 
 void PlayerState::applyOn(PlayerState* state) {
+    modified = true;
     //update player's informations
     for (std::map<int, Atribute>::const_iterator it = state->atributes.begin();
         it != state->atributes.end(); ++it) {
@@ -632,6 +657,7 @@ void PlayerState::applyOn(PlayerState* state) {
 }
 
 void PlayerState::removeNull() {
+    modified = true;
     IntAtributeMap tempMap;
 
     for (IntAtributeMapCit it = atributes.begin();
@@ -909,6 +935,18 @@ bool PilotState::hasVehicleSet() const {
     return isAtributeSet(31); //m_iVehicleNum
 }
 
+PlayerState* PilotState::clone() {
+    PilotState* ps = new PilotState();
+
+    ps->atributes = this->atributes;
+    ps->stats = this->stats;
+    ps->persistant = this->persistant;
+    ps->ammo = this->ammo;
+    ps->powerups = this->powerups;
+
+    return ps;
+}
+
 void VehicleState::report(std::ostream& os) const {
     os << "    ";
     for (std::map<int, Atribute>::const_iterator it = atributes.begin();
@@ -1141,4 +1179,16 @@ bool VehicleState::isAtributeInteger(int id) const {
     return !isAtributeFloat(id);
 }
 
+PlayerState* VehicleState::clone() {
+    VehicleState* ps = new VehicleState();
+
+    ps->atributes = this->atributes;
+    ps->stats = this->stats;
+    ps->persistant = this->persistant;
+    ps->ammo = this->ammo;
+    ps->powerups = this->powerups;
+
+    return ps;
+}
+
 DEMO_NAMESPACE_END
\ No newline at end of file
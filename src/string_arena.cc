@@ -0,0 +1,50 @@
+#include <jka/string_arena.h>
+
+#include <cstring>
+
+DEMO_NAMESPACE_START
+
+std::string_view StringArena::store(std::string_view s) {
+    if (s.empty())
+        return std::string_view();
+
+    char* data;
+
+    if (s.size() > BLOCK_SIZE / 4) {
+        //long strings get a block of their own, current block stays in use
+        blocks.push_back(std::unique_ptr<char[]>(new char[s.size()]));
+        data = blocks.back().get();
+    }
+    else {
+        if (!current || used + s.size() > BLOCK_SIZE) {
+            blocks.push_back(std::unique_ptr<char[]>(new char[BLOCK_SIZE]));
+            current = blocks.back().get();
+            used = 0;
+        }
+
+        data = current + used;
+        used += s.size();
+    }
+
+    memcpy(data, s.data(), s.size());
+    total += s.size();
+
+    return std::string_view(data, s.size());
+}
+
+void StringArena::clear() {
+    std::unique_ptr<char[]> kept;
+
+    for (size_t i = 0; i < blocks.size(); ++i)
+        if (blocks[i].get() == current)
+            kept = std::move(blocks[i]);
+
+    blocks.clear();
+    if (kept)
+        blocks.push_back(std::move(kept));
+
+    used = 0;
+    total = 0;
+}
+
+DEMO_NAMESPACE_END